@@ -0,0 +1,153 @@
+// Runs many independent headless games across all cores and prints a summary.
+// Game i is seeded with seed + i, so a batch is reproducible whatever the
+// thread count or scheduling order.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "controller.h"
+#include "fixed_point.h"
+#include "game.h"
+#include "thread_pool.h"
+
+namespace {
+
+struct GameResult {
+  int score;
+  int ai_score;
+  std::size_t ticks;
+  double seconds;
+};
+
+struct Stat {
+  double min{0};
+  double mean{0};
+  double max{0};
+};
+
+template <typename Field>
+Stat Summarize(const std::vector<GameResult> &results, Field field) {
+  Stat stat;
+  stat.min = stat.max = field(results.front());
+  double sum = 0;
+  for (const auto &result : results) {
+    double value = field(result);
+    stat.min = std::min(stat.min, value);
+    stat.max = std::max(stat.max, value);
+    sum += value;
+  }
+  stat.mean = sum / results.size();
+  return stat;
+}
+
+void PrintStat(const char *label, const Stat &stat) {
+  std::cout << label << " min " << stat.min << "  mean " << stat.mean
+            << "  max " << stat.max << "\n";
+}
+
+void PrintUsage(const char *program) {
+  std::cerr << "Usage: " << program
+            << " [--games N] [--threads N] [--seed N] [--ticks N]"
+               " [--grid W H] [--ai N] [--hazards N]"
+               " [--policy "
+            << Game::PolicyNames() << "] [--think-us N]\n";
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  std::size_t games = 1000;
+  std::size_t threads = 0;  // One per hardware thread
+  std::uint32_t seed = 1;
+  std::size_t max_ticks = 100000;
+  std::size_t grid_width = 32;
+  std::size_t grid_height = 32;
+  std::size_t ai_snakes = 1;
+  std::size_t hazards = 3;
+  Game::AIPolicy policy = Game::AIPolicy::kSearch;
+  std::size_t think_us = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+      games = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+      max_ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--grid") == 0 && i + 2 < argc) {
+      grid_width = std::strtoull(argv[++i], nullptr, 10);
+      grid_height = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--ai") == 0 && i + 1 < argc) {
+      ai_snakes = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--hazards") == 0 && i + 1 < argc) {
+      hazards = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--policy") == 0 && i + 1 < argc &&
+               Game::ParsePolicy(argv[i + 1], policy)) {
+      ++i;
+    } else if (std::strcmp(argv[i], "--think-us") == 0 && i + 1 < argc) {
+      think_us = std::strtoull(argv[++i], nullptr, 10);
+    } else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (games == 0 || grid_width < 4 || grid_height < 4 ||
+      grid_width > kFixedMaxCells || grid_height > kFixedMaxCells) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  // Each task writes only its own slot, so no locking is needed.
+  std::vector<GameResult> results(games);
+  Controller controller;
+  auto start = std::chrono::steady_clock::now();
+  {
+    ThreadPool pool(threads);
+    std::cout << "Running " << games << " games on " << pool.Size()
+              << " threads\n";
+    for (std::size_t i = 0; i < games; ++i) {
+      pool.Submit([&, i] {
+        // Games already run in parallel, so each plans its AI snakes on the
+        // worker it runs on.
+        Game game(grid_width, grid_height,
+                  seed + static_cast<std::uint32_t>(i), ai_snakes, hazards,
+                  policy);
+        game.SetThinkBudget(std::chrono::microseconds(think_us));
+        double seconds = game.RunHeadless(controller, max_ticks, nullptr);
+        results[i] = {game.GetScore(), game.GetAIScore(), game.GetTicks(),
+                      seconds};
+      });
+    }
+    pool.Wait();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::size_t ai_wins = 0;
+  std::size_t total_ticks = 0;
+  for (const auto &result : results) {
+    if (result.ai_score > result.score) ai_wins++;
+    total_ticks += result.ticks;
+  }
+
+  PrintStat("Score:         ",
+            Summarize(results, [](const GameResult &r) { return r.score; }));
+  PrintStat("AI score:      ",
+            Summarize(results, [](const GameResult &r) { return r.ai_score; }));
+  PrintStat("Survival ticks:", Summarize(results, [](const GameResult &r) {
+              return static_cast<double>(r.ticks);
+            }));
+  PrintStat("us per tick:   ", Summarize(results, [](const GameResult &r) {
+              return r.ticks > 0 ? r.seconds * 1e6 / r.ticks : 0.0;
+            }));
+  std::cout << "AI wins: " << ai_wins << " / " << games << "\n";
+  std::cout << "Total ticks: " << total_ticks << " in " << elapsed.count()
+            << " s (" << total_ticks / elapsed.count() << " ticks/s)\n";
+  return 0;
+}
@@ -0,0 +1,418 @@
+// Microbenchmarks for the simulation and render hot paths. Each benchmark is
+// run over a grid of parameters (board size, snake length, obstacle count,
+// board fill) and reported as nanoseconds per operation, either as a table or
+// as JSON in the layout Google Benchmark uses, so existing comparison tools
+// can diff two runs.
+//
+// Game internals such as ComputeAIDirection and PlaceFood are private; they
+// are measured through the public pieces they are made of (FlowField,
+// Bitboard, OccupancyGrid's free-cell set) and through whole ticks.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bitboard.h"
+#include "controller.h"
+#include "flow_field.h"
+#include "frame_snapshot.h"
+#include "game.h"
+#include "obstacles.h"
+#include "occupancy_grid.h"
+#include "renderer.h"
+#include "snake.h"
+
+namespace {
+
+struct Result {
+  std::string name;
+  std::size_t iterations;  // Operations timed over all repetitions
+  double ns_per_op;        // Wall time, median of the repetitions
+  double min_ns_per_op;    // Wall time, fastest repetition
+  double cpu_ns_per_op;    // Process CPU time over all repetitions
+};
+
+// Results are folded into this so the compiler can't drop the work.
+volatile std::size_t sink = 0;
+
+class Harness {
+ public:
+  Harness(std::string filter, double min_seconds, int repetitions)
+      : filter(std::move(filter)),
+        min_seconds(min_seconds),
+        repetitions(repetitions) {}
+
+  // Times `batch`, which performs some operations and returns how many.
+  // Each repetition calls it until it has run for its share of the minimum
+  // time; the reported figure is the median repetition.
+  void Run(const std::string &name, const std::function<std::size_t()> &batch) {
+    if (name.find(filter) == std::string::npos) return;
+    using Clock = std::chrono::steady_clock;
+
+    batch();  // Warm-up: caches, lazily grown buffers
+    std::vector<double> samples;
+    std::size_t total = 0;
+    const std::clock_t cpu_start = std::clock();
+    const std::chrono::duration<double> share(min_seconds / repetitions);
+    for (int r = 0; r < repetitions; ++r) {
+      std::size_t ops = 0;
+      const auto start = Clock::now();
+      auto elapsed = Clock::duration::zero();
+      do {
+        ops += batch();
+        elapsed = Clock::now() - start;
+      } while (elapsed < share);
+      samples.push_back(std::chrono::duration<double, std::nano>(elapsed).count() /
+                        std::max<std::size_t>(ops, 1));
+      total += ops;
+    }
+    const double cpu_ns =
+        1e9 * static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    std::sort(samples.begin(), samples.end());
+    results.push_back({name, total, samples[samples.size() / 2], samples.front(),
+                       cpu_ns / std::max<std::size_t>(total, 1)});
+    if (!quiet) {
+      std::cerr << name << ": " << results.back().ns_per_op << " ns/op\n";
+    }
+  }
+
+  const std::vector<Result> &Results() const { return results; }
+  bool quiet{false};
+
+ private:
+  std::string filter;
+  double min_seconds;
+  int repetitions;
+  std::vector<Result> results;
+};
+
+std::string Name(std::string base,
+                 std::initializer_list<std::pair<const char *, std::size_t>> params) {
+  for (const auto &param : params) {
+    base.append("/").append(param.first).append(":").append(
+        std::to_string(param.second));
+  }
+  return base;
+}
+
+// Covers `percent` of the board with fixed obstacles at random.
+void Fill(OccupancyGrid &occupancy, std::size_t percent, std::mt19937 &engine) {
+  const std::size_t cells =
+      static_cast<std::size_t>(occupancy.Width()) * occupancy.Height();
+  const std::size_t target = cells * percent / 100;
+  while (cells - occupancy.FreeCount() < target) {
+    std::uniform_int_distribution<std::size_t> pick(0, occupancy.FreeCount() - 1);
+    const int cell = occupancy.FreeCell(pick(engine));
+    occupancy.Set(cell % occupancy.Width(), cell / occupancy.Width(),
+                  OccupancyGrid::kFixedObstacle);
+  }
+}
+
+SDL_Point RandomFree(const OccupancyGrid &occupancy, std::mt19937 &engine) {
+  std::uniform_int_distribution<std::size_t> pick(0, occupancy.FreeCount() - 1);
+  const int cell = occupancy.FreeCell(pick(engine));
+  return {cell % occupancy.Width(), cell / occupancy.Width()};
+}
+
+constexpr std::size_t kGrids[] = {32, 128, 512};
+constexpr std::size_t kFills[] = {0, 25, 50, 75};
+
+// A full recompute of the food field: what RefreshFoodField costs when the
+// food moves, shared by every AI snake.
+void BenchFlowField(Harness &harness) {
+  for (std::size_t grid : kGrids) {
+    for (std::size_t fill : kFills) {
+      std::mt19937 engine(1);
+      OccupancyGrid occupancy(grid, grid);
+      Fill(occupancy, fill, engine);
+      FlowField field(grid, grid);
+      std::vector<SDL_Point> goals(64);
+      for (auto &goal : goals) goal = RandomFree(occupancy, engine);
+      std::size_t next = 0;
+      harness.Run(Name("field/compute", {{"grid", grid}, {"fill", fill}}),
+                  [&] {
+                    const SDL_Point goal = goals[next++ % goals.size()];
+                    field.Compute(occupancy, goal);
+                    sink = sink + field.Distance(0, 0);
+                    return std::size_t{1};
+                  });
+    }
+  }
+}
+
+// Snake::Update at full speed, so every call crosses into a new cell and
+// runs UpdateBody.
+void BenchSnakeUpdate(Harness &harness) {
+  constexpr std::size_t kGrid = 512;
+  for (std::size_t length : {4, 64, 400}) {
+    OccupancyGrid occupancy(kGrid, kGrid);
+    Snake snake(kGrid, kGrid, OccupancyGrid::kPlayerBody);
+    snake.direction = Snake::Direction::kRight;
+    snake.speed = kFixedOne;
+    snake.Occupy(occupancy);
+    while (snake.size < static_cast<int>(length)) {
+      snake.GrowBody();
+      snake.Update(occupancy);
+    }
+    harness.Run(Name("snake/update", {{"length", length}}), [&] {
+      snake.Update(occupancy);
+      return std::size_t{1};
+    });
+  }
+}
+
+// Occupancy lookups at random cells, as in the planners and collision checks.
+void BenchOccupied(Harness &harness) {
+  constexpr std::size_t kLookups = 1024;
+  for (std::size_t grid : kGrids) {
+    for (std::size_t fill : kFills) {
+      std::mt19937 engine(3);
+      OccupancyGrid occupancy(grid, grid);
+      Fill(occupancy, fill, engine);
+      std::vector<SDL_Point> cells(kLookups);
+      std::uniform_int_distribution<int> coordinate(0, static_cast<int>(grid) - 1);
+      for (auto &cell : cells) cell = {coordinate(engine), coordinate(engine)};
+      harness.Run(Name("occupancy/occupied", {{"grid", grid}, {"fill", fill}}),
+                  [&] {
+                    std::size_t hits = 0;
+                    for (const auto &cell : cells) {
+                      hits += occupancy.Occupied(cell.x, cell.y);
+                    }
+                    sink = sink + hits;
+                    return kLookups;
+                  });
+    }
+  }
+}
+
+// Bitboard flood fills from random free cells, as in ComputeAIDirection's
+// safety check: capped at a snake's worth of room, and uncapped so the whole
+// reachable area is counted.
+void BenchReachable(Harness &harness) {
+  for (std::size_t grid : kGrids) {
+    for (std::size_t fill : kFills) {
+      for (std::size_t limit : {std::size_t{64}, grid * grid}) {
+        std::mt19937 engine(7);
+        OccupancyGrid occupancy(grid, grid);
+        Fill(occupancy, fill, engine);
+        Bitboard reach(grid, grid);
+        Bitboard spare(grid, grid);
+        std::vector<SDL_Point> starts(64);
+        for (auto &start : starts) start = RandomFree(occupancy, engine);
+        std::size_t next = 0;
+        harness.Run(Name("bitboard/reachable",
+                         {{"grid", grid}, {"fill", fill}, {"limit", limit}}),
+                    [&] {
+                      const SDL_Point start = starts[next++ % starts.size()];
+                      sink = sink + Bitboard::CountReachable(
+                                        occupancy.OccupiedBits(), start.x,
+                                        start.y, limit, reach, spare);
+                      return std::size_t{1};
+                    });
+      }
+    }
+  }
+}
+
+// One food placement: a uniform draw from the free-cell set, plus the
+// Set/Clear pair that keeps the set current as the food is eaten and moved.
+void BenchPlaceFood(Harness &harness) {
+  for (std::size_t grid : kGrids) {
+    for (std::size_t fill : {0, 50, 90, 99}) {
+      std::mt19937 engine(4);
+      OccupancyGrid occupancy(grid, grid);
+      Fill(occupancy, fill, engine);
+      harness.Run(Name("food/place", {{"grid", grid}, {"fill", fill}}), [&] {
+        const SDL_Point food = RandomFree(occupancy, engine);
+        occupancy.Set(food.x, food.y, OccupancyGrid::kPlayerBody);
+        occupancy.Clear(food.x, food.y, OccupancyGrid::kPlayerBody);
+        return std::size_t{1};
+      });
+    }
+  }
+}
+
+void BenchObstacles(Harness &harness) {
+  constexpr std::size_t kGrid = 256;
+  for (std::size_t count : {3, 1000, 10000}) {
+    std::mt19937 engine(5);
+    OccupancyGrid occupancy(kGrid, kGrid);
+    MovingObstacles obstacles(kGrid, kGrid);
+    std::uniform_int_distribution<int> direction(0, 3);
+    for (std::size_t i = 0; i < count; ++i) {
+      const SDL_Point cell = RandomFree(occupancy, engine);
+      obstacles.Add(cell.x, cell.y,
+                    static_cast<Snake::Direction>(direction(engine)),
+                    FixedFromDouble(0.05), occupancy);
+    }
+    harness.Run(Name("obstacles/step", {{"count", count}}), [&] {
+      obstacles.Step(occupancy);
+      return std::size_t{1};
+    });
+  }
+}
+
+// Whole headless ticks with the player on autopilot, restarting from a fresh
+// copy of the same game whenever the player dies, under the search policy as
+// game/tick, the cycle policy as game/tick_cycle and the Monte Carlo policy
+// as game/tick_montecarlo.
+void BenchTick(Harness &harness) {
+  struct Config {
+    std::size_t grid, ai, hazards;
+  };
+  for (Game::AIPolicy policy :
+       {Game::AIPolicy::kSearch, Game::AIPolicy::kCycle,
+        Game::AIPolicy::kMonteCarlo}) {
+    for (Config config : {Config{32, 1, 3}, Config{128, 8, 100},
+                          Config{512, 64, 1000}}) {
+      Controller controller;
+      const Game start(config.grid, config.grid, 1, config.ai, config.hazards,
+                       policy);
+      Game game = start;
+      const char *name = policy == Game::AIPolicy::kCycle ? "game/tick_cycle"
+                         : policy == Game::AIPolicy::kMonteCarlo
+                             ? "game/tick_montecarlo"
+                             : "game/tick";
+      harness.Run(Name(name,
+                       {{"grid", config.grid},
+                        {"ai", config.ai},
+                        {"hazards", config.hazards}}),
+                  [&] {
+                    if (game.IsOver()) game = start;
+                    const std::size_t before = game.GetTicks();
+                    game.RunHeadless(controller, before + 64, nullptr);
+                    return game.GetTicks() - before;
+                  });
+    }
+  }
+}
+
+// Filling a snapshot for the render thread, and taking a view of it.
+void BenchSnapshot(Harness &harness) {
+  for (std::size_t ai : {1, 64}) {
+    const std::size_t grid = ai > 1 ? 512 : 32;
+    Controller controller;
+    Game game(grid, grid, 1, ai, 3);
+    game.RunHeadless(controller, 2000, nullptr);
+    FrameSnapshot snapshot(grid * grid, ai, Game::kFixedObstacles, 3);
+    harness.Run(Name("frame/snapshot", {{"grid", grid}, {"ai", ai}}), [&] {
+      game.Snapshot(snapshot);
+      sink = sink + snapshot.View(0.5f, {}).ai.size;
+      return std::size_t{1};
+    });
+  }
+}
+
+// Needs a display, so only runs when asked for.
+void BenchRender(Harness &harness) {
+  for (std::size_t ai : {1, 64}) {
+    const std::size_t grid = ai > 1 ? 128 : 32;
+    Controller controller;
+    Game game(grid, grid, 1, ai, 3);
+    game.RunHeadless(controller, 2000, nullptr);
+    FrameSnapshot snapshot(grid * grid, ai, Game::kFixedObstacles, 3);
+    game.Snapshot(snapshot);
+    Renderer renderer(640, 640, grid, grid);
+    harness.Run(Name("renderer/render", {{"grid", grid}, {"ai", ai}}), [&] {
+      renderer.Render(snapshot.View(0.5f, {}));
+      renderer.Present();
+      return std::size_t{1};
+    });
+  }
+}
+
+void WriteJson(std::ostream &out, const std::vector<Result> &results) {
+  char date[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+  out << "{\n  \"context\": {\n"
+      << "    \"date\": \"" << date << "\",\n"
+      << "    \"num_cpus\": " << std::thread::hardware_concurrency() << "\n"
+      << "  },\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const Result &result = results[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name
+        << "\", \"run_type\": \"iteration\", \"iterations\": "
+        << result.iterations << ", \"real_time\": " << result.ns_per_op
+        << ", \"cpu_time\": " << result.cpu_ns_per_op
+        << ", \"min_real_time\": " << result.min_ns_per_op
+        << ", \"time_unit\": \"ns\"}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+void PrintUsage(const char *program) {
+  std::cerr << "Usage: " << program
+            << " [--filter TEXT] [--min-time SECONDS] [--repetitions N]"
+               " [--json FILE] [--render]\n";
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  std::string filter;
+  double min_seconds = 0.5;
+  int repetitions = 5;
+  std::string json_path;
+  bool render = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      min_seconds = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+      repetitions = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--render") == 0) {
+      render = true;
+    } else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (min_seconds <= 0 || repetitions < 1) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  Harness harness(filter, min_seconds, repetitions);
+  // With JSON going to stdout, progress would only get in the way.
+  harness.quiet = json_path == "-";
+  BenchFlowField(harness);
+  BenchSnakeUpdate(harness);
+  BenchOccupied(harness);
+  BenchReachable(harness);
+  BenchPlaceFood(harness);
+  BenchObstacles(harness);
+  BenchTick(harness);
+  BenchSnapshot(harness);
+  if (render) BenchRender(harness);
+
+  if (json_path == "-") {
+    WriteJson(std::cout, harness.Results());
+  } else if (!json_path.empty()) {
+    std::ofstream out(json_path);
+    WriteJson(out, harness.Results());
+    if (!out) {
+      std::cerr << "Could not write " << json_path << "\n";
+      return 1;
+    }
+  } else {
+    for (const Result &result : harness.Results()) {
+      std::cout << result.name << "  " << result.ns_per_op << " ns/op\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "bitboard.h"
+#include <algorithm>
+#include <bitset>
+
+namespace {
+
+inline int PopCount(std::uint64_t word) {
+  return static_cast<int>(std::bitset<64>(word).count());
+}
+
+}  // namespace
+
+Bitboard::Bitboard(std::size_t width, std::size_t height)
+    : width(static_cast<int>(width)),
+      height(static_cast<int>(height)),
+      row_words((width + 63) / 64),
+      last_mask(width % 64 == 0 ? ~std::uint64_t{0}
+                                : (std::uint64_t{1} << (width % 64)) - 1),
+      words(row_words * height, 0) {}
+
+void Bitboard::Clear() { std::fill(words.begin(), words.end(), 0); }
+
+std::size_t Bitboard::Expand(const Bitboard &in, const Bitboard &blocked,
+                             int first, int rows, Bitboard &out) {
+  const std::size_t n = in.row_words;
+  const int h = in.height;
+  const int top_bit = (in.width - 1) & 63;  // Column width - 1, in the last word
+  std::size_t count = 0;
+
+  for (int i = 0; i < rows; ++i) {
+    const int y = (first + i) % h;
+    const std::uint64_t *row = &in.words[y * n];
+    const std::uint64_t *above = &in.words[((y + h - 1) % h) * n];
+    const std::uint64_t *below = &in.words[((y + 1) % h) * n];
+    const std::uint64_t *wall = &blocked.words[y * n];
+    std::uint64_t *dest = &out.words[y * n];
+
+    // Bits crossing the row's ends wrap to the other side.
+    const std::uint64_t left_edge = row[0] & 1;
+    const std::uint64_t right_edge = (row[n - 1] >> top_bit) & 1;
+    for (std::size_t w = 0; w < n; ++w) {
+      std::uint64_t east = row[w] << 1;  // Cell x moves to x + 1
+      east |= w > 0 ? row[w - 1] >> 63 : right_edge;
+      std::uint64_t west = row[w] >> 1;  // Cell x moves to x - 1
+      west |= w + 1 < n ? row[w + 1] << 63 : left_edge << top_bit;
+      std::uint64_t grown = row[w] | east | west | above[w] | below[w];
+      if (w + 1 == n) grown &= in.last_mask;
+      dest[w] = grown & ~wall[w];
+      count += PopCount(dest[w]);
+    }
+  }
+  return count;
+}
+
+std::size_t Bitboard::CountReachable(const Bitboard &blocked, int x, int y,
+                                     std::size_t limit, Bitboard &reach,
+                                     Bitboard &spare) {
+  if (blocked.Test(x, y)) return 0;
+  reach.Set(x, y);
+
+  // Reach grows by at most one row each way per step, so only a band of
+  // rows around the start needs visiting until it covers the board.
+  const int h = blocked.height;
+  int first = y;
+  int rows = 1;
+  std::size_t count = 1;
+  Bitboard *current = &reach;
+  Bitboard *next = &spare;
+  while (count < limit) {
+    first = (first + h - 1) % h;
+    rows = std::min(h, rows + 2);
+    if (rows == h) first = 0;
+    const std::size_t grown = Expand(*current, blocked, first, rows, *next);
+    std::swap(current, next);
+    if (grown == count) break;  // Nothing new: the whole area is counted
+    count = grown;
+  }
+
+  // Leave both boards clear for the next call, touching only the band.
+  const std::size_t n = blocked.row_words;
+  for (int i = 0; i < rows; ++i) {
+    const std::size_t row = static_cast<std::size_t>((first + i) % h) * n;
+    std::fill_n(&reach.words[row], n, 0);
+    std::fill_n(&spare.words[row], n, 0);
+  }
+  return count;
+}
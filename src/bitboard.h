@@ -0,0 +1,53 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One bit per grid cell, each row packed into 64-bit words (a single word for
+// boards up to 64 wide, so the default 32x32 board is 128 bytes). Set
+// operations and one-step neighbour expansion work a word at a time, wrapping
+// at the edges like the snakes do, which makes flood fills and reachable-area
+// counts cheap enough to run for every candidate move.
+class Bitboard {
+ public:
+  Bitboard(std::size_t width, std::size_t height);
+
+  void Set(int x, int y) { words[Word(x, y)] |= Bit(x); }
+  void Reset(int x, int y) { words[Word(x, y)] &= ~Bit(x); }
+  bool Test(int x, int y) const { return (words[Word(x, y)] & Bit(x)) != 0; }
+  void Clear();
+
+  int Width() const { return width; }
+  int Height() const { return height; }
+
+  // Number of cells reachable from (x, y) through cells not set in
+  // `blocked`, counting (x, y) itself; 0 if it is blocked. Stops early once
+  // `limit` cells are known to be reachable, returning a value of at least
+  // `limit`. `reach` and `spare` are working boards of the same size, which
+  // must be clear and are left clear.
+  static std::size_t CountReachable(const Bitboard &blocked, int x, int y,
+                                    std::size_t limit, Bitboard &reach,
+                                    Bitboard &spare);
+
+ private:
+  std::size_t Word(int x, int y) const {
+    return static_cast<std::size_t>(y) * row_words + (x >> 6);
+  }
+  static std::uint64_t Bit(int x) { return std::uint64_t{1} << (x & 63); }
+
+  // `out` = `in` grown by one cell left, right, up and down, minus `blocked`,
+  // for `rows` rows starting at `first` (wrapping). Returns the new count of
+  // set bits in those rows.
+  static std::size_t Expand(const Bitboard &in, const Bitboard &blocked,
+                            int first, int rows, Bitboard &out);
+
+  int width;
+  int height;
+  std::size_t row_words;      // Words per row
+  std::uint64_t last_mask;    // Valid bits of a row's last word
+  std::vector<std::uint64_t> words;
+};
+
+#endif
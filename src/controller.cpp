@@ -9,11 +9,52 @@ void Controller::ChangeDirection(Snake &snake, Snake::Direction input,
   return;
 }
 
-void Controller::HandleInput(bool &running, Snake &snake, bool &paused, bool game_over, std::string &name_input) const {  // Modified: Added game_over and name_input
+void Controller::Steer(Snake &snake, Snake::Direction input) const {
+  switch (input) {
+    case Snake::Direction::kUp:
+      ChangeDirection(snake, input, Snake::Direction::kDown);
+      break;
+    case Snake::Direction::kDown:
+      ChangeDirection(snake, input, Snake::Direction::kUp);
+      break;
+    case Snake::Direction::kLeft:
+      ChangeDirection(snake, input, Snake::Direction::kRight);
+      break;
+    case Snake::Direction::kRight:
+      ChangeDirection(snake, input, Snake::Direction::kLeft);
+      break;
+  }
+}
+
+void Controller::Apply(InputCommand command, Snake &snake, bool &paused) const {
+  switch (command) {
+    case InputCommand::kUp:
+      Steer(snake, Snake::Direction::kUp);
+      break;
+    case InputCommand::kDown:
+      Steer(snake, Snake::Direction::kDown);
+      break;
+    case InputCommand::kLeft:
+      Steer(snake, Snake::Direction::kLeft);
+      break;
+    case InputCommand::kRight:
+      Steer(snake, Snake::Direction::kRight);
+      break;
+    case InputCommand::kTogglePause:
+      paused = !paused;
+      break;
+  }
+}
+
+void Controller::HandleInput(bool &running, bool game_over,
+                             std::string &name_input, InputQueue &commands,
+                             bool &show_profiler) const {
   SDL_Event e;
   while (SDL_PollEvent(&e)) {
     if (e.type == SDL_QUIT) {
       running = false;
+    } else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F3) {
+      show_profiler = !show_profiler;
     } else if (game_over) {
       // Handle text input for name
       if (e.type == SDL_TEXTINPUT) {
@@ -38,27 +79,23 @@ void Controller::HandleInput(bool &running, Snake &snake, bool &paused, bool gam
       if (e.type == SDL_KEYDOWN) {
         switch (e.key.keysym.sym) {
           case SDLK_UP:
-            ChangeDirection(snake, Snake::Direction::kUp,
-                            Snake::Direction::kDown);
+            commands.Push(InputCommand::kUp);
             break;
 
           case SDLK_DOWN:
-            ChangeDirection(snake, Snake::Direction::kDown,
-                            Snake::Direction::kUp);
+            commands.Push(InputCommand::kDown);
             break;
 
           case SDLK_LEFT:
-            ChangeDirection(snake, Snake::Direction::kLeft,
-                            Snake::Direction::kRight);
+            commands.Push(InputCommand::kLeft);
             break;
 
           case SDLK_RIGHT:
-            ChangeDirection(snake, Snake::Direction::kRight,
-                            Snake::Direction::kLeft);
+            commands.Push(InputCommand::kRight);
             break;
 
           case SDLK_ESCAPE:
-            paused = !paused;
+            commands.Push(InputCommand::kTogglePause);
             break;
 
           case SDLK_q:
@@ -2,11 +2,25 @@
 #define CONTROLLER_H
 
 #include "snake.h"
+#include "spsc_queue.h"
 #include <string>
 
+// Gameplay requests, forwarded from the input thread to the simulation.
+enum class InputCommand { kUp, kDown, kLeft, kRight, kTogglePause };
+using InputQueue = SpscQueue<InputCommand, 64>;
+
 class Controller {
  public:
-  void HandleInput(bool &running, Snake &snake, bool &paused, bool game_over, std::string &name_input) const;  // Modified: Added bool &paused parameter game_over and name_input
+  // Drains SDL events on the input thread. Quitting, name entry and the
+  // profiler overlay (F3) are handled here; steering and pausing are queued
+  // on `commands` for the simulation thread to Apply().
+  void HandleInput(bool &running, bool game_over, std::string &name_input,
+                   InputQueue &commands, bool &show_profiler) const;
+  // Simulation side of a queued command.
+  void Apply(InputCommand command, Snake &snake, bool &paused) const;
+  // Applies a direction request from a non-keyboard source (script or
+  // autopilot) with the same no-reversing rule as the arrow keys.
+  void Steer(Snake &snake, Snake::Direction input) const;
 
  private:
   void ChangeDirection(Snake &snake, Snake::Direction input,
@@ -0,0 +1,29 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cstdint>
+
+// Positions and speeds on the board, in 16.16 fixed point: the high 16 bits
+// are the cell and the low 16 the fraction of the way across it. Integer
+// adds are exact, so a position is the same after any number of steps on
+// any compiler, and finding a position's cell is a shift. Boards up to
+// kFixedMaxCells cells across fit; anything that takes a board size from
+// outside must check it against that.
+using Fixed = std::int32_t;
+
+constexpr int kFixedShift = 16;
+constexpr Fixed kFixedOne = Fixed{1} << kFixedShift;
+constexpr int kFixedMaxCells = (1 << (31 - kFixedShift)) - 1;  // 32767
+
+constexpr Fixed FixedFromInt(int cells) { return cells * kFixedOne; }
+// Rounded to the nearest 1/65536 of a cell.
+constexpr Fixed FixedFromDouble(double cells) {
+  return static_cast<Fixed>(cells * kFixedOne + (cells < 0 ? -0.5 : 0.5));
+}
+// The cell a position on the board, which is never negative, lies in.
+constexpr int FixedCell(Fixed position) { return position >> kFixedShift; }
+constexpr float FixedToFloat(Fixed value) {
+  return static_cast<float>(value) / kFixedOne;
+}
+
+#endif
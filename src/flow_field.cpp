@@ -0,0 +1,41 @@
+#include "flow_field.h"
+#include <algorithm>
+#include "grid_geometry.h"
+
+FlowField::FlowField(std::size_t grid_width, std::size_t grid_height)
+    : width(static_cast<int>(grid_width)),
+      height(static_cast<int>(grid_height)),
+      distance(grid_width * grid_height, kUnreachable) {
+  queue.reserve(grid_width * grid_height);
+}
+
+void FlowField::Compute(const OccupancyGrid &occupancy, SDL_Point goal) {
+  this->goal = goal;
+  version = occupancy.Version();
+  std::fill(distance.begin(), distance.end(), kUnreachable);
+  queue.clear();
+
+  const int start = goal.y * width + goal.x;
+  distance[start] = 0;
+  queue.push_back(start);
+  DispatchGrid(width, height,
+               [&](auto grid) { Search(grid, occupancy); });
+}
+
+template <typename Grid>
+void FlowField::Search(Grid grid, const OccupancyGrid &occupancy) {
+  // Every step costs 1, so a plain FIFO visits cells in distance order.
+  for (std::size_t head = 0; head < queue.size(); ++head) {
+    const int cell = queue[head];
+    const int next_distance = distance[cell] + 1;
+    auto visit = [&](int next) {
+      if (distance[next] != kUnreachable) return;
+      distance[next] = next_distance;
+      if (!occupancy.Occupied(next)) queue.push_back(next);
+    };
+    visit(grid.Left(cell));
+    visit(grid.Right(cell));
+    visit(grid.Up(cell));
+    visit(grid.Down(cell));
+  }
+}
@@ -0,0 +1,50 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "SDL.h"
+#include "occupancy_grid.h"
+
+// Breadth-first distances from one goal cell over the occupancy grid,
+// wrapping at the edges like the snakes. One field towards the food serves
+// every computer-steered snake: a snake's shortest path starts at whichever
+// free neighbour of its head is closest, so choosing a move is four lookups
+// and the board is searched once per food, not once per snake.
+//
+// Free cells get their distance to the goal. Occupied cells next to reached
+// free ones also get a distance, one more than their closest free neighbour,
+// but the search doesn't continue through them. A snake's head is such a
+// cell, which lets a snake tell when the field has gone stale under it: a
+// head with a finite distance should always have a free neighbour one closer.
+class FlowField {
+ public:
+  static constexpr int kUnreachable = std::numeric_limits<int>::max();
+
+  FlowField(std::size_t grid_width, std::size_t grid_height);
+
+  // Recomputes every distance towards `goal` over `occupancy` as it is now.
+  void Compute(const OccupancyGrid &occupancy, SDL_Point goal);
+
+  int Distance(int x, int y) const { return distance[y * width + x]; }
+  int Distance(int cell) const { return distance[cell]; }
+  SDL_Point Goal() const { return goal; }
+  // OccupancyGrid::Version() when the field was computed.
+  std::uint64_t Version() const { return version; }
+
+ private:
+  // Runs the search out from the queued goal, on `grid`'s geometry.
+  template <typename Grid>
+  void Search(Grid grid, const OccupancyGrid &occupancy);
+
+  int width;
+  int height;
+  SDL_Point goal{-1, -1};
+  std::uint64_t version{0};
+  std::vector<int> distance;
+  std::vector<int> queue;  // BFS frontier, reused between computes
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "frame_profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+FrameProfiler::FrameProfiler(bool tracing)
+    : origin(std::chrono::steady_clock::now()), tracing(tracing) {}
+
+const char *FrameProfiler::Name(Phase phase) {
+  switch (phase) {
+    case Phase::kInput:
+      return "input";
+    case Phase::kPlanning:
+      return "planning";
+    case Phase::kSimulation:
+      return "simulation";
+    case Phase::kRender:
+      return "render";
+    case Phase::kPresent:
+      break;
+  }
+  return "present";
+}
+
+int FrameProfiler::ThreadIndex() {
+  const std::size_t id = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  auto found = std::find(threads.begin(), threads.end(), id);
+  if (found != threads.end()) return static_cast<int>(found - threads.begin());
+  threads.push_back(id);
+  return static_cast<int>(threads.size() - 1);
+}
+
+void FrameProfiler::Record(Phase phase,
+                           std::chrono::steady_clock::time_point start,
+                           std::chrono::steady_clock::time_point end) {
+  const std::int64_t duration =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  const int p = static_cast<int>(phase);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  window[p][recorded[p] % kWindow] = duration;
+  ++recorded[p];
+  if (tracing && spans.size() < kMaxSpans) {
+    spans.push_back(
+        {phase, ThreadIndex(),
+         std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin)
+             .count(),
+         duration});
+  }
+}
+
+FrameProfiler::Stats FrameProfiler::PhaseStats(Phase phase) const {
+  const int p = static_cast<int>(phase);
+  std::int64_t samples[kWindow];
+  std::size_t count;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    count = std::min(recorded[p], kWindow);
+    std::copy(window[p], window[p] + count, samples);
+  }
+
+  Stats stats;
+  stats.samples = count;
+  if (count == 0) return stats;
+  std::sort(samples, samples + count);
+  double sum = 0;
+  for (std::size_t i = 0; i < count; ++i) sum += samples[i];
+  stats.min_us = samples[0] / 1e3;
+  stats.max_us = samples[count - 1] / 1e3;
+  stats.mean_us = sum / count / 1e3;
+  stats.p99_us = samples[std::min(count - 1, count * 99 / 100)] / 1e3;
+  return stats;
+}
+
+void FrameProfiler::Describe(std::vector<std::string> &lines) const {
+  lines.resize(kPhases + 1);
+  lines[0].assign("phase         min   mean    p99    max (us)");
+  char buffer[96];
+  for (int p = 0; p < kPhases; ++p) {
+    const Phase phase = static_cast<Phase>(p);
+    const Stats stats = PhaseStats(phase);
+    std::snprintf(buffer, sizeof(buffer), "%-10s %6.1f %6.1f %6.1f %6.1f",
+                  Name(phase), stats.min_us, stats.mean_us, stats.p99_us,
+                  stats.max_us);
+    lines[p + 1].assign(buffer);
+  }
+}
+
+bool FrameProfiler::WriteTrace(const std::string &path) const {
+  std::ofstream out(path);
+  if (!out) {
+    std::cerr << "Could not write trace " << path << "\n";
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  // Complete ("X") events; timestamps and durations are in microseconds.
+  out << "{\"traceEvents\":[";
+  char buffer[160];
+  for (std::size_t i = 0; i < spans.size(); ++i) {
+    const Span &span = spans[i];
+    std::snprintf(buffer, sizeof(buffer),
+                  "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                  "\"ts\":%.3f,\"dur\":%.3f}",
+                  i == 0 ? "" : ",", Name(span.phase), span.thread,
+                  span.start_ns / 1e3, span.duration_ns / 1e3);
+    out << buffer;
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return static_cast<bool>(out);
+}
@@ -0,0 +1,87 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Times the phases of the interactive loop. Every phase keeps its last
+// kWindow durations, from which min/mean/p99/max are computed on demand, and
+// with tracing on every timed span is also kept, up to a limit, for export as
+// a Chrome trace-event file (chrome://tracing or ui.perfetto.dev). Phases are
+// timed on both the input and the simulation thread, so recording takes a
+// lock; it is held for a few stores.
+class FrameProfiler {
+ public:
+  enum class Phase { kInput, kPlanning, kSimulation, kRender, kPresent };
+  static constexpr int kPhases = 5;
+  static constexpr std::size_t kWindow = 240;
+
+  struct Stats {
+    double min_us{0};
+    double mean_us{0};
+    double p99_us{0};
+    double max_us{0};
+    std::size_t samples{0};
+  };
+
+  explicit FrameProfiler(bool tracing = false);
+
+  void Record(Phase phase, std::chrono::steady_clock::time_point start,
+              std::chrono::steady_clock::time_point end);
+  Stats PhaseStats(Phase phase) const;
+  static const char *Name(Phase phase);
+
+  // Formats one line per phase into `lines`, reusing its strings.
+  void Describe(std::vector<std::string> &lines) const;
+
+  // Writes the recorded spans as Chrome trace events. Returns false, with a
+  // message on stderr, if the file can't be written.
+  bool WriteTrace(const std::string &path) const;
+
+ private:
+  struct Span {
+    Phase phase;
+    int thread;
+    std::int64_t start_ns;
+    std::int64_t duration_ns;
+  };
+  static constexpr std::size_t kMaxSpans = 1 << 20;
+
+  int ThreadIndex();  // Small id per recording thread; takes the lock held
+
+  mutable std::mutex mutex;
+  const std::chrono::steady_clock::time_point origin;
+  std::int64_t window[kPhases][kWindow]{};  // Durations in ns, a ring each
+  std::size_t recorded[kPhases]{};          // Total samples per phase
+  bool tracing;
+  std::vector<Span> spans;
+  std::vector<std::size_t> threads;  // Hashes of thread ids seen so far
+};
+
+// Times the enclosing scope as `phase`. Does nothing without a profiler.
+class ProfileScope {
+ public:
+  ProfileScope(FrameProfiler *profiler, FrameProfiler::Phase phase)
+      : profiler(profiler), phase(phase) {
+    if (profiler != nullptr) start = std::chrono::steady_clock::now();
+  }
+  ~ProfileScope() {
+    if (profiler != nullptr) {
+      profiler->Record(phase, start, std::chrono::steady_clock::now());
+    }
+  }
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+ private:
+  FrameProfiler *profiler;
+  FrameProfiler::Phase phase;
+  std::chrono::steady_clock::time_point start;
+};
+
+#endif
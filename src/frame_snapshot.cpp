@@ -0,0 +1,55 @@
+#include "frame_snapshot.h"
+
+namespace {
+
+SnakeView ViewOf(FrameSnapshot::SnakeState const &snake) {
+  SnakeView view;
+  view.body[0] = {snake.body.data(), snake.body.size()};
+  view.body[1] = {};
+  view.head_x = snake.head_x;
+  view.head_y = snake.head_y;
+  view.prev_head_x = snake.prev_head_x;
+  view.prev_head_y = snake.prev_head_y;
+  view.alive = snake.alive;
+  return view;
+}
+
+}  // namespace
+
+FrameSnapshot::FrameSnapshot(std::size_t cells, std::size_t ai_snakes,
+                             std::size_t fixed_count,
+                             std::size_t moving_count) {
+  player.body.reserve(cells);
+  ai_bodies.reserve(cells);
+  ai.reserve(ai_snakes);
+  fixed_obstacles.reserve(fixed_count);
+  for (auto *positions : {&moving_obstacles.x, &moving_obstacles.y,
+                          &moving_obstacles.prev_x, &moving_obstacles.prev_y}) {
+    positions->reserve(moving_count);
+  }
+  global_high_name.reserve(64);
+}
+
+FrameView FrameSnapshot::View(float alpha, std::string_view name_input) const {
+  FrameView view;
+  view.player = ViewOf(player);
+  view.ai = {ai.data(), ai.size()};
+  view.food = food;
+  view.fixed_obstacles = {fixed_obstacles.data(), fixed_obstacles.size()};
+  view.moving_obstacles.x = {moving_obstacles.x.data(), moving_obstacles.x.size()};
+  view.moving_obstacles.y = {moving_obstacles.y.data(), moving_obstacles.y.size()};
+  view.moving_obstacles.prev_x = {moving_obstacles.prev_x.data(),
+                                  moving_obstacles.prev_x.size()};
+  view.moving_obstacles.prev_y = {moving_obstacles.prev_y.data(),
+                                  moving_obstacles.prev_y.size()};
+  view.score = score;
+  view.ai_score = ai_score;
+  view.global_high_score = global_high_score;
+  view.global_high_name = global_high_name;
+  view.name_input = name_input;
+  view.paused = paused;
+  view.game_over = game_over;
+  view.overlay = {};
+  view.alpha = alpha;
+  return view;
+}
@@ -0,0 +1,62 @@
+#ifndef FRAME_SNAPSHOT_H
+#define FRAME_SNAPSHOT_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SDL.h"
+#include "frame_view.h"
+
+// A self-contained copy of everything drawn in a frame, handed from the
+// simulation thread to the render thread through a TripleBuffer. Buffers are
+// reserved up front for a full board and for the game's AI snakes and
+// obstacles, whose numbers never grow, so refilling a snapshot every tick
+// never allocates.
+struct FrameSnapshot {
+  FrameSnapshot(std::size_t cells, std::size_t ai_snakes,
+                std::size_t fixed_count, std::size_t moving_count);
+  // `ai` points into the snapshot's own storage.
+  FrameSnapshot(const FrameSnapshot &) = delete;
+  FrameSnapshot &operator=(const FrameSnapshot &) = delete;
+
+  struct SnakeState {
+    std::vector<SDL_Point> body;  // Tail first
+    float head_x;
+    float head_y;
+    float prev_head_x;
+    float prev_head_y;
+    bool alive;
+  };
+
+  SnakeState player;
+  // Every AI snake's body back to back, and one view per snake into it.
+  std::vector<SDL_Point> ai_bodies;
+  std::vector<SnakeView> ai;
+  SDL_Point food;
+  std::vector<SDL_Point> fixed_obstacles;
+  struct {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> prev_x;
+    std::vector<float> prev_y;
+  } moving_obstacles;
+
+  int score;
+  int ai_score;
+  int global_high_score;
+  std::string global_high_name;
+  bool paused;
+  bool game_over;
+
+  std::uint64_t sequence{0};  // Increases with every published snapshot
+  std::chrono::steady_clock::time_point published_at;
+
+  // Borrowed view for the renderer. The name being typed lives on the input
+  // thread, so it is passed in rather than snapshotted.
+  FrameView View(float alpha, std::string_view name_input) const;
+};
+
+#endif
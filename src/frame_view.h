@@ -0,0 +1,65 @@
+#ifndef FRAME_VIEW_H
+#define FRAME_VIEW_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "SDL.h"
+
+// Read-only view of a contiguous run of elements (std::span is C++20).
+template <typename T>
+struct Span {
+  const T *data{nullptr};
+  std::size_t size{0};
+
+  const T *begin() const { return data; }
+  const T *end() const { return data + size; }
+};
+
+struct SnakeView {
+  // The body, tail first, as up to two contiguous runs, so a view can also
+  // sit directly on a snake's ring buffer, which may wrap around its end.
+  Span<SDL_Point> body[2];
+  float head_x;
+  float head_y;
+  float prev_head_x;
+  float prev_head_y;
+  bool alive;
+};
+
+// Moving obstacles as parallel arrays of positions after and before the last
+// step, all of the same length.
+struct MovingObstaclesView {
+  Span<float> x;
+  Span<float> y;
+  Span<float> prev_x;
+  Span<float> prev_y;
+};
+
+// Everything the renderer needs to draw one frame, as pointers into storage
+// owned elsewhere (a FrameSnapshot), so handing it over copies nothing and
+// allocates nothing. Valid for as long as that storage is left alone.
+struct FrameView {
+  SnakeView player;
+  Span<SnakeView> ai;
+  SDL_Point food;
+  Span<SDL_Point> fixed_obstacles;
+  MovingObstaclesView moving_obstacles;
+
+  // HUD
+  int score;
+  int ai_score;  // Best score among the AI snakes
+  int global_high_score;
+  std::string_view global_high_name;
+  std::string_view name_input;
+  bool paused;
+  bool game_over;
+  // Profiler lines drawn over the board; empty when the overlay is off.
+  Span<std::string> overlay;
+
+  // How far the frame lies between the previous and the latest simulation
+  // step, in [0, 1]; moving things are drawn interpolated by it.
+  float alpha;
+};
+
+#endif
@@ -1,65 +1,144 @@
 #include "game.h"
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <thread>
 #include <fstream>  // Added
 #include <string>   // Added (though included via header)
 #include "SDL.h"
-#include <cmath>
-#include <queue>    // Added: For priority_queue in A*
-#include <tuple>    // Added: For priority_queue tuples
-#include <limits>   // Added: For numeric_limits
+#include <algorithm>
 #include <vector>
-#include <algorithm>  // For reverse
+#include "frame_profiler.h"
+#include "replay.h"
+#include "thread_pool.h"
+
+namespace {
+
+// The policies' command-line names, in AIPolicy order.
+constexpr const char *kPolicyNames[] = {"search", "cycle", "montecarlo"};
+
+}  // namespace
+
+bool Game::ParsePolicy(const char *name, AIPolicy &policy) {
+  for (std::size_t i = 0; i < std::size(kPolicyNames); ++i) {
+    if (std::strcmp(name, kPolicyNames[i]) == 0) {
+      policy = static_cast<AIPolicy>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string Game::PolicyNames() {
+  std::string names;
+  for (const char *name : kPolicyNames) {
+    if (!names.empty()) names += '|';
+    names += name;
+  }
+  return names;
+}
 
 Game::Game(std::size_t grid_width, std::size_t grid_height)
-    : snake(grid_width, grid_height),
-      ai_snake(grid_width, grid_height),  // Added
-      engine(dev()),
-      random_w(0, static_cast<int>(grid_width - 1)),
-      random_h(0, static_cast<int>(grid_height - 1)),
+    : Game(grid_width, grid_height, std::random_device{}()) {}
+
+Game::Game(std::size_t grid_width, std::size_t grid_height, std::uint32_t seed,
+           std::size_t ai_snakes, std::size_t hazards, AIPolicy policy)
+    : snake(grid_width, grid_height, OccupancyGrid::kPlayerBody),
+      occupancy(grid_width, grid_height),
+      food_field(grid_width, grid_height),
+      planning_scratch(1, PlanningScratch(grid_width, grid_height)),
+      policy(policy),
+      engine(seed),
+      moving_obstacles(grid_width, grid_height),
       grid_width_(grid_width),  // Added
       grid_height_(grid_height) {  // Added
   // Added: Random distribution for directions
   std::uniform_int_distribution<int> random_dir(0, 3);
 
-  // Added: Initialize AI snake position and direction
-  ai_snake.head_x = grid_width / 4.0f;
-  ai_snake.head_y = grid_height / 2.0f;
-  ai_snake.direction = Snake::Direction::kRight;
+  snake.Occupy(occupancy);
+
+  // Added: The first AI snake starts left of the player, heading right
+  agents.reserve(ai_snakes);
+  if (ai_snakes > 0) {
+    Snake &first = agents.emplace_back(grid_width, grid_height).snake;
+    first.head_x = first.prev_head_x =
+        FixedFromDouble(static_cast<double>(grid_width) / 4);
+    first.head_y = first.prev_head_y =
+        FixedFromDouble(static_cast<double>(grid_height) / 2);
+    first.direction = Snake::Direction::kRight;
+    first.Occupy(occupancy);
+  }
 
-  // Added: Place fixed obstacles (5)
-  for (int i = 0; i < 5; ++i) {
+  // Added: Place fixed obstacles
+  for (std::size_t i = 0; i < kFixedObstacles; ++i) {
     int x, y;
-    bool valid;
-    do {
-      x = random_w(engine);
-      y = random_h(engine);
-      valid = !snake.SnakeCell(x, y) && !ai_snake.SnakeCell(x, y);  // Modified: Avoid AI snake
-      for (const auto& ob : fixed_obstacles) {
-        if (ob.x == x && ob.y == y) valid = false;
-      }
-    } while (!valid);
+    if (!RandomFreeCell(x, y)) break;  // Avoid snakes and other obstacles
     fixed_obstacles.push_back({x, y});
+    occupancy.Set(x, y, OccupancyGrid::kFixedObstacle);
+  }
+
+  // Added: Place moving obstacles, slower than the snakes' initial 0.1
+  moving_obstacles.Reserve(hazards);
+  for (std::size_t i = 0; i < hazards; ++i) {
+    int x, y;
+    if (!RandomFreeCell(x, y)) break;
+    moving_obstacles.Add(x, y,
+                         static_cast<Snake::Direction>(random_dir(engine)),
+                         FixedFromDouble(0.05), occupancy);
   }
 
-  // Added: Place moving obstacles (3)
-  for (int i = 0; i < 3; ++i) {
+  // Any further AI snakes start on free cells in random directions.
+  while (agents.size() < ai_snakes) {
     int x, y;
-    bool valid;
-    do {
-      x = random_w(engine);
-      y = random_h(engine);
-      valid = !snake.SnakeCell(x, y) && !ai_snake.SnakeCell(x, y) && !IsObstacle(x, y);  // Modified: Avoid AI snake
-    } while (!valid);
-    MovingObstacle mo;
-    mo.x = static_cast<float>(x);
-    mo.y = static_cast<float>(y);
-    mo.dir = static_cast<Snake::Direction>(random_dir(engine));
-    moving_obstacles.push_back(mo);
+    if (!RandomFreeCell(x, y)) break;
+    Snake &extra = agents.emplace_back(grid_width, grid_height).snake;
+    extra.head_x = extra.prev_head_x = FixedFromInt(x);
+    extra.head_y = extra.prev_head_y = FixedFromInt(y);
+    extra.direction = static_cast<Snake::Direction>(random_dir(engine));
+    extra.Occupy(occupancy);
+  }
+
+  if (policy == AIPolicy::kCycle) {
+    auto tour = std::make_shared<const HamiltonianCycle>(grid_width, grid_height);
+    if (tour->Valid()) cycle = std::move(tour);
   }
 
+  planning_scratch.front().Reserve(agents.size() + 1, moving_obstacles.Size());
   PlaceFood();
+}
 
-  // Added: Load high scores
+void Game::SetPlanningPool(ThreadPool *pool) {
+  planning_pool = pool;
+  const std::size_t tasks = pool != nullptr ? pool->Size() : 1;
+  if (planning_scratch.size() < tasks) {
+    planning_scratch.resize(tasks, planning_scratch.front());
+    for (PlanningScratch &scratch : planning_scratch) {
+      scratch.Reserve(agents.size() + 1, moving_obstacles.Size());
+    }
+  }
+}
+
+void Game::RecordTo(Replay *replay) { recording = replay; }
+
+void Game::SetThinkBudget(std::chrono::microseconds budget) {
+  think_budget = budget;
+}
+
+void Game::SetProfiler(FrameProfiler *frame_profiler) {
+  profiler = frame_profiler;
+}
+
+void Game::Apply(Controller const &controller, InputCommand command) {
+  const Snake::Direction before = snake.direction;
+  controller.Apply(command, snake, paused);
+  if (recording != nullptr && snake.direction != before) {
+    recording->events.push_back({ticks, command});
+  }
+}
+
+// Added: Load high scores
+void Game::LoadHighScores() {
   std::ifstream in("highscore.txt");
   std::string n;
   int s;
@@ -73,49 +152,121 @@ Game::Game(std::size_t grid_width, std::size_t grid_height)
 }
 
 void Game::Run(Controller const &controller, Renderer &renderer,
-               std::size_t target_frame_duration) {
-  Uint32 title_timestamp = SDL_GetTicks();
-  Uint32 frame_start;
-  Uint32 frame_end;
-  Uint32 frame_duration;
+               std::size_t ticks_per_second, std::size_t frames_per_second) {
+  using Clock = std::chrono::steady_clock;
+  const auto tick = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / ticks_per_second));
+  const auto frame = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / frames_per_second));
+
+  // Input flows to the simulation through `commands`, frames flow back
+  // through `frames`; neither side ever blocks on the other.
+  InputQueue commands;
+  TripleBuffer<FrameSnapshot> frames(grid_width_ * grid_height_, agents.size(),
+                                     fixed_obstacles.size(),
+                                     moving_obstacles.Size());
+  std::atomic<bool> simulating{true};
+
+  Snapshot(frames.WriteSlot());
+  frames.Publish();
+  std::thread simulation(&Game::Simulate, this, std::cref(controller),
+                         std::ref(commands), std::ref(frames),
+                         std::cref(simulating), ticks_per_second);
+
+  auto title_timestamp = Clock::now();
   int frame_count = 0;
   bool running = true;
   bool text_input_active = false;  // Added
+  bool show_profiler = false;
+  std::vector<std::string> overlay;  // Profiler lines, reused every frame
 
-  while (running) {
-    frame_start = SDL_GetTicks();
-
-    controller.HandleInput(running, snake, paused, game_over, name_input);  // Modified: Passed game_over and name_input
+  // What the last presented frame showed, to skip redrawing an idle screen.
+  std::uint64_t drawn_sequence = 0;
+  bool drawn_once = false;
+  Uint32 drawn_blink_phase = 0;
+  std::string drawn_name;
+  auto last_draw = title_timestamp;
 
-    if (game_over) {
-      if (!text_input_active) {
-        SDL_StartTextInput();
-        text_input_active = true;
-      }
-    } else if (!paused) {
-      Update();
+  while (running) {
+    const auto frame_start = Clock::now();
+    frames.Acquire();
+    const FrameSnapshot &latest = frames.ReadSlot();
+
+    {
+      ProfileScope timer(profiler, FrameProfiler::Phase::kInput);
+      controller.HandleInput(running, latest.game_over, name_input, commands,
+                             show_profiler);
     }
+    if (profiler == nullptr) show_profiler = false;
 
-    // Modified: Passed obstacles and AI snake to renderer
-    renderer.Render(snake, ai_snake, food, paused, game_over, score, ai_score, name_input, global_high_score, global_high_name,
-                    fixed_obstacles, moving_obstacles);
+    if (latest.game_over && !text_input_active) {
+      SDL_StartTextInput();
+      text_input_active = true;
+    }
 
-    frame_end = SDL_GetTicks();
+    // Interpolate from the previous step towards the latest one by how much
+    // of a tick has passed since it was published.
+    const bool animating = !latest.paused && !latest.game_over;
+    float alpha = 1.0f;
+    if (animating) {
+      alpha = std::chrono::duration<float>(frame_start - latest.published_at) /
+              std::chrono::duration<float>(tick);
+      if (alpha > 1.0f) alpha = 1.0f;
+    }
 
-    frame_count++;
-    frame_duration = frame_end - frame_start;
+    // Redraw while the game is animating or the profiler overlay is up, and
+    // otherwise only when something visible changed: a new snapshot, typed
+    // name or the cursor blink. A slow keep-alive redraw covers window
+    // damage. Between redraws an idle game blocks on the event queue rather
+    // than waking every frame.
+    const Uint32 blink_phase = latest.game_over ? (SDL_GetTicks() / 500) % 2 : 0;
+    const bool redraw = animating || show_profiler || !drawn_once ||
+                        latest.sequence != drawn_sequence ||
+                        blink_phase != drawn_blink_phase ||
+                        name_input != drawn_name ||
+                        frame_start - last_draw >= std::chrono::seconds(1);
+
+    if (redraw) {
+      FrameView view = latest.View(alpha, name_input);
+      if (show_profiler) {
+        profiler->Describe(overlay);
+        view.overlay = {overlay.data(), overlay.size()};
+      }
+      {
+        ProfileScope timer(profiler, FrameProfiler::Phase::kRender);
+        renderer.Render(view);
+      }
+      {
+        ProfileScope timer(profiler, FrameProfiler::Phase::kPresent);
+        renderer.Present();
+      }
+      frame_count++;
+      drawn_once = true;
+      drawn_sequence = latest.sequence;
+      drawn_blink_phase = blink_phase;
+      if (name_input != drawn_name) drawn_name = name_input;
+      last_draw = frame_start;
+    }
 
-    if (frame_end - title_timestamp >= 1000) {
-      renderer.UpdateWindowTitle(score, frame_count);
+    const auto frame_end = Clock::now();
+    if (frame_end - title_timestamp >= std::chrono::seconds(1)) {
+      renderer.UpdateWindowTitle(latest.score, frame_count);
       frame_count = 0;
       title_timestamp = frame_end;
     }
 
-    if (frame_duration < target_frame_duration) {
-      SDL_Delay(target_frame_duration - frame_duration);
+    if (redraw) {
+      std::this_thread::sleep_until(frame_start + frame);
+    } else {
+      // Wakes as soon as input arrives; the event stays queued for
+      // HandleInput. The timeout bounds the wait so the blink stays on time.
+      SDL_WaitEventTimeout(nullptr, 100);
     }
   }
 
+  simulating.store(false, std::memory_order_release);
+  simulation.join();
+
   if (text_input_active) {
     SDL_StopTextInput();
   }
@@ -126,17 +277,110 @@ void Game::Run(Controller const &controller, Renderer &renderer,
   }
 }
 
-void Game::PlaceFood() {
-  int x, y;
-  while (true) {
-    x = random_w(engine);
-    y = random_h(engine);
-    // Modified: Also check not on AI snake or obstacle
-    if (!snake.SnakeCell(x, y) && !ai_snake.SnakeCell(x, y) && !IsObstacle(x, y)) {
-      food.x = x;
-      food.y = y;
-      return;
+void Game::Simulate(Controller const &controller, InputQueue &commands,
+                    TripleBuffer<FrameSnapshot> &frames,
+                    std::atomic<bool> const &simulating,
+                    std::size_t ticks_per_second) {
+  using Clock = std::chrono::steady_clock;
+  const auto tick = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / ticks_per_second));
+  // If the simulation falls further behind than this (a stall, a slow
+  // search), the backlog is dropped rather than replayed in a burst.
+  const auto max_lag = 5 * tick;
+
+  std::uint64_t sequence = 0;
+  auto next_tick = Clock::now();
+  while (simulating.load(std::memory_order_acquire)) {
+    bool changed = false;
+    InputCommand command;
+    while (commands.Pop(command)) {
+      if (game_over) continue;
+      bool was_paused = paused;
+      Apply(controller, command);
+      changed |= paused != was_paused;
+    }
+
+    if (!paused && !game_over) {
+      Update();
+      changed = true;
+    }
+
+    if (changed) {
+      FrameSnapshot &snapshot = frames.WriteSlot();
+      Snapshot(snapshot);
+      snapshot.sequence = ++sequence;
+      snapshot.published_at = Clock::now();
+      frames.Publish();
+    }
+
+    next_tick += tick;
+    const auto now = Clock::now();
+    if (now - next_tick > max_lag) {
+      next_tick = now;
     }
+    std::this_thread::sleep_until(next_tick);
+  }
+}
+
+namespace {
+
+InputCommand SteeringCommand(Snake::Direction direction) {
+  switch (direction) {
+    case Snake::Direction::kUp:
+      return InputCommand::kUp;
+    case Snake::Direction::kDown:
+      return InputCommand::kDown;
+    case Snake::Direction::kLeft:
+      return InputCommand::kLeft;
+    case Snake::Direction::kRight:
+      break;
+  }
+  return InputCommand::kRight;
+}
+
+}  // namespace
+
+double Game::RunHeadless(Controller const &controller, std::size_t max_ticks,
+                         InputScript *script) {
+  // Without a script the player is steered like an AI snake. It borrows the
+  // AI's scratch, which is idle between ticks.
+  AIMemory autopilot;
+  auto start = std::chrono::steady_clock::now();
+
+  while (!game_over && ticks < max_ticks) {
+    if (script != nullptr) {
+      script->Play(ticks, [&](Snake::Direction input) {
+        Apply(controller, SteeringCommand(input));
+      });
+    } else {
+      RefreshFoodField();
+      ShareThinkTime(ThinkDeadline(), 1, planning_scratch.front());
+      Apply(controller, SteeringCommand(ComputeAIDirection(
+                            snake, autopilot, planning_scratch.front())));
+    }
+    Update();
+  }
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+bool Game::RandomFreeCell(int &x, int &y) {
+  const std::size_t free = occupancy.FreeCount();
+  if (free == 0) return false;
+  std::uniform_int_distribution<std::size_t> pick(0, free - 1);
+  const int cell = occupancy.FreeCell(pick(engine));
+  x = cell % occupancy.Width();
+  y = cell / occupancy.Width();
+  return true;
+}
+
+void Game::PlaceFood() {
+  // Modified: Drawn from the free cells, so never on a snake or obstacle.
+  // On a full board the food is taken off it until the next placement.
+  if (!RandomFreeCell(food.x, food.y)) {
+    food = {-1, -1};
   }
 }
 
@@ -145,55 +389,53 @@ void Game::Update() {
     game_over = true;  // Modified: Set game_over
     return;
   }
-
-  // Added: Compute AI direction using A*
-  if (ai_snake.alive) {
-    ai_snake.direction = ComputeAIDirection();
+  ticks++;
+
+  // Every AI snake plans against the same occupancy, which stays frozen until
+  // all plans are in. Moves and collisions are then resolved one snake at a
+  // time in a fixed order, so the outcome doesn't depend on how planning was
+  // scheduled.
+  {
+    ProfileScope timer(profiler, FrameProfiler::Phase::kPlanning);
+    PlanAgents();
   }
+  ProfileScope timer(profiler, FrameProfiler::Phase::kSimulation);
 
   // Added: Update moving obstacles first
-  for (auto& mo : moving_obstacles) {
-    switch (mo.dir) {
-      case Snake::Direction::kUp:
-        mo.y -= mo.speed;
-        break;
-      case Snake::Direction::kDown:
-        mo.y += mo.speed;
-        break;
-      case Snake::Direction::kLeft:
-        mo.x -= mo.speed;
-        break;
-      case Snake::Direction::kRight:
-        mo.x += mo.speed;
-        break;
-    }
-    // Wrap around like snake
-    mo.x = std::fmod(mo.x + static_cast<float>(random_w.max() + 1), static_cast<float>(random_w.max() + 1));
-    mo.y = std::fmod(mo.y + static_cast<float>(random_h.max() + 1), static_cast<float>(random_h.max() + 1));
-  }
+  moving_obstacles.Step(occupancy);
 
-  snake.Update();
-  if (ai_snake.alive) {
-    ai_snake.Update();
+  snake.Update(occupancy);
+  for (auto &agent : agents) {
+    if (agent.snake.alive) {
+      agent.snake.Update(occupancy);
+    }
   }
 
-  int player_x = static_cast<int>(snake.head_x);
-  int player_y = static_cast<int>(snake.head_y);
-  int ai_x = static_cast<int>(ai_snake.head_x);
-  int ai_y = static_cast<int>(ai_snake.head_y);
+  int player_x = snake.HeadCell().x;
+  int player_y = snake.HeadCell().y;
 
-  // Added: Check for obstacle collision for both
+  // Added: Check for obstacle collision for all snakes
   if (IsObstacle(player_x, player_y)) {
     snake.alive = false;
     game_over = true;
     return;
   }
-  if (ai_snake.alive && IsObstacle(ai_x, ai_y)) {
-    ai_snake.alive = false;
+  for (auto &agent : agents) {
+    Snake &ai_snake = agent.snake;
+    if (ai_snake.alive && IsObstacle(ai_snake.HeadCell().x,
+                                     ai_snake.HeadCell().y)) {
+      ai_snake.alive = false;
+    }
   }
 
-  // Added: Check inter-snake collisions
-  if (snake.alive && ai_snake.alive) {
+  // Added: Check inter-snake collisions. AI snakes running into one another
+  // are caught by Snake::Update, as they share an occupancy tag; the one
+  // moved first wins a head-to-head.
+  for (auto &agent : agents) {
+    Snake &ai_snake = agent.snake;
+    if (!ai_snake.alive) continue;
+    int ai_x = ai_snake.HeadCell().x;
+    int ai_y = ai_snake.HeadCell().y;
     if (player_x == ai_x && player_y == ai_y) {
       // Head-to-head collision
       snake.alive = false;
@@ -201,37 +443,185 @@ void Game::Update() {
       game_over = true;
       return;
     }
-    if (ai_snake.SnakeCell(player_x, player_y)) {
-      // Player head hits AI body
-      snake.alive = false;
-      game_over = true;
-      return;
-    }
-    if (snake.SnakeCell(ai_x, ai_y)) {
+    if (occupancy.Test(ai_x, ai_y, OccupancyGrid::kPlayerBody)) {
       // AI head hits player body
       ai_snake.alive = false;
     }
   }
+  if (occupancy.Test(player_x, player_y, OccupancyGrid::kAIBody)) {
+    // Player head hits AI body
+    snake.alive = false;
+    game_over = true;
+    return;
+  }
 
   // Check food for player
   if (snake.alive && food.x == player_x && food.y == player_y) {
     score++;
     PlaceFood();
     snake.GrowBody();
-    snake.speed += 0.02;
+    snake.SpeedUp(FixedFromDouble(0.02));
   }
 
-  // Check food for AI
-  if (ai_snake.alive && food.x == ai_x && food.y == ai_y) {
-    ai_score++;
-    PlaceFood();
-    ai_snake.GrowBody();
-    ai_snake.speed += 0.02;
+  // Check food for the AI snakes, in order
+  for (auto &agent : agents) {
+    Snake &ai_snake = agent.snake;
+    if (ai_snake.alive && food.x == ai_snake.HeadCell().x &&
+        food.y == ai_snake.HeadCell().y) {
+      agent.score++;
+      PlaceFood();
+      ai_snake.GrowBody();
+      ai_snake.SpeedUp(FixedFromDouble(0.02));
+    }
+  }
+}
+
+void Game::PlanAgents() {
+  RefreshFoodField();
+  const std::size_t tasks =
+      planning_pool != nullptr
+          ? std::min(planning_scratch.size(), agents.size())
+          : 1;
+  const auto deadline = ThinkDeadline();
+  // Each task owns one scratch. Agents are dealt out round-robin, so a few
+  // expensive flood fills don't all land on the same task. The think budget
+  // runs in parallel on every task, split evenly among its agents.
+  auto plan = [this, tasks, deadline](std::size_t task) {
+    for (std::size_t i = task; i < agents.size(); i += tasks) {
+      Snake &ai_snake = agents[i].snake;
+      if (ai_snake.alive) {
+        PlanningScratch &scratch = planning_scratch[task];
+        ShareThinkTime(deadline, (agents.size() - 1 - i) / tasks + 1, scratch);
+        ai_snake.direction =
+            ComputeAIDirection(ai_snake, agents[i].memory, scratch);
+      }
+    }
+  };
+  if (tasks <= 1) {
+    plan(0);
+    return;
   }
+  for (std::size_t task = 0; task < tasks; ++task) {
+    planning_pool->Submit([&plan, task] { plan(task); });
+  }
+  planning_pool->Wait();
+}
+
+namespace {
+
+void CopySnake(Snake const &snake, FrameSnapshot::SnakeState &out) {
+  auto first = snake.body.FirstRun();
+  auto second = snake.body.SecondRun();
+  out.body.assign(first.first, first.first + first.second);
+  out.body.insert(out.body.end(), second.first, second.first + second.second);
+  out.head_x = FixedToFloat(snake.head_x);
+  out.head_y = FixedToFloat(snake.head_y);
+  out.prev_head_x = FixedToFloat(snake.prev_head_x);
+  out.prev_head_y = FixedToFloat(snake.prev_head_y);
+  out.alive = snake.alive;
+}
+
+// Fixed-point positions as the floats the renderer interpolates.
+void CopyPositions(const std::vector<Fixed> &from, std::vector<float> &to) {
+  to.resize(from.size());
+  std::transform(from.begin(), from.end(), to.begin(), FixedToFloat);
+}
+
+}  // namespace
+
+Game::Checkpoint::Checkpoint(Game const &game)
+    : food(game.food),
+      occupancy(game.occupancy),
+      food_field(game.food_field),
+      moving_obstacles(game.moving_obstacles),
+      engine(game.engine),
+      score(game.score),
+      ticks(game.ticks),
+      paused(game.paused),
+      game_over(game.game_over) {
+  snakes.reserve(game.agents.size() + 1);
+  snakes.push_back(game.snake.Compact());
+  for (AIAgent const &agent : game.agents) {
+    snakes.push_back(agent.snake.Compact());
+    memories.push_back(agent.memory);
+    ai_scores.push_back(agent.score);
+  }
+}
+
+Game::Checkpoint Game::Save() const { return Checkpoint(*this); }
+
+void Game::Restore(Checkpoint const &checkpoint) {
+  snake.Restore(checkpoint.snakes.front());
+  for (std::size_t i = 0; i < agents.size(); ++i) {
+    agents[i].snake.Restore(checkpoint.snakes[i + 1]);
+    agents[i].memory = checkpoint.memories[i];
+    agents[i].score = checkpoint.ai_scores[i];
+  }
+  food = checkpoint.food;
+  occupancy = checkpoint.occupancy;
+  food_field = checkpoint.food_field;
+  moving_obstacles = checkpoint.moving_obstacles;
+  engine = checkpoint.engine;
+  score = checkpoint.score;
+  ticks = checkpoint.ticks;
+  paused = checkpoint.paused;
+  game_over = checkpoint.game_over;
+}
+
+void Game::Snapshot(FrameSnapshot &out) const {
+  CopySnake(snake, out.player);
+
+  // All AI bodies go into one buffer first; the views are pointed into it
+  // only once it can no longer reallocate.
+  out.ai_bodies.clear();
+  out.ai.resize(agents.size());
+  for (std::size_t i = 0; i < agents.size(); ++i) {
+    Snake const &ai_snake = agents[i].snake;
+    SnakeView &view = out.ai[i];
+    view.body[0].size = ai_snake.body.FirstRun().second;
+    view.body[1].size = ai_snake.body.SecondRun().second;
+    for (auto run : {ai_snake.body.FirstRun(), ai_snake.body.SecondRun()}) {
+      out.ai_bodies.insert(out.ai_bodies.end(), run.first,
+                           run.first + run.second);
+    }
+    view.head_x = FixedToFloat(ai_snake.head_x);
+    view.head_y = FixedToFloat(ai_snake.head_y);
+    view.prev_head_x = FixedToFloat(ai_snake.prev_head_x);
+    view.prev_head_y = FixedToFloat(ai_snake.prev_head_y);
+    view.alive = ai_snake.alive;
+  }
+  const SDL_Point *cells = out.ai_bodies.data();
+  for (SnakeView &view : out.ai) {
+    view.body[0].data = cells;
+    cells += view.body[0].size;
+    view.body[1].data = cells;
+    cells += view.body[1].size;
+  }
+
+  out.food = food;
+  out.fixed_obstacles.assign(fixed_obstacles.begin(), fixed_obstacles.end());
+  CopyPositions(moving_obstacles.X(), out.moving_obstacles.x);
+  CopyPositions(moving_obstacles.Y(), out.moving_obstacles.y);
+  CopyPositions(moving_obstacles.PrevX(), out.moving_obstacles.prev_x);
+  CopyPositions(moving_obstacles.PrevY(), out.moving_obstacles.prev_y);
+  out.score = score;
+  out.ai_score = GetAIScore();
+  out.global_high_score = global_high_score;
+  out.global_high_name = global_high_name;
+  out.paused = paused;
+  out.game_over = game_over;
 }
 
 int Game::GetScore() const { return score; }
 int Game::GetSize() const { return snake.size; }
+int Game::GetAIScore() const {
+  int best = 0;
+  for (const auto &agent : agents) {
+    best = std::max(best, agent.score);
+  }
+  return best;
+}
+std::size_t Game::GetTicks() const { return ticks; }
 
 // Added
 void Game::SaveHighScore() {
@@ -246,92 +636,344 @@ void Game::SaveHighScore() {
 
 // Added: Helper to check if a cell is an obstacle
 bool Game::IsObstacle(int x, int y) const {
-  for (const auto& ob : fixed_obstacles) {
-    if (ob.x == x && ob.y == y) return true;
-  }
-  for (const auto& mo : moving_obstacles) {
-    if (static_cast<int>(mo.x) == x && static_cast<int>(mo.y) == y) return true;
+  return occupancy.Test(x, y, OccupancyGrid::kObstacle);
+}
+
+namespace {
+
+// The cell one step from `from` in direction `dir`, wrapping at the edges.
+SDL_Point Neighbour(SDL_Point from, Snake::Direction dir, int width,
+                    int height) {
+  switch (dir) {
+    case Snake::Direction::kUp:
+      return {from.x, (from.y + height - 1) % height};
+    case Snake::Direction::kDown:
+      return {from.x, (from.y + 1) % height};
+    case Snake::Direction::kLeft:
+      return {(from.x + width - 1) % width, from.y};
+    case Snake::Direction::kRight:
+      break;
   }
-  return false;
+  return {(from.x + 1) % width, from.y};
 }
 
-// Added: Helper for A* to check blocked cells (obstacles + both snakes)
-bool Game::IsBlocked(int x, int y) const {
-  if (IsObstacle(x, y)) return true;
-  if (snake.SnakeCell(x, y)) return true;
-  if (ai_snake.SnakeCell(x, y)) return true;
-  return false;
+bool Opposite(Snake::Direction a, Snake::Direction b) {
+  using D = Snake::Direction;
+  return (a == D::kUp && b == D::kDown) || (a == D::kDown && b == D::kUp) ||
+         (a == D::kLeft && b == D::kRight) || (a == D::kRight && b == D::kLeft);
 }
 
-// Added: Compute direction for AI using A* pathfinding
-Snake::Direction Game::ComputeAIDirection() {
-  int start_x = static_cast<int>(ai_snake.head_x);
-  int start_y = static_cast<int>(ai_snake.head_y);
-  int goal_x = food.x;
-  int goal_y = food.y;
+}  // namespace
+
+void Game::RefreshFoodField() {
+  if (food.x < 0) return;
+  const SDL_Point goal = food_field.Goal();
+  bool stale = goal.x != food.x || goal.y != food.y;
+  if (!stale && food_field.Version() != occupancy.Version()) {
+    // A head the field can't reach may have been freed since, and with no
+    // closer neighbour to follow it would never find out.
+    auto stuck = [this](Snake const &mover) {
+      const SDL_Point head = mover.HeadCell();
+      const int d = food_field.Distance(head.x, head.y);
+      if (!mover.alive || d == 0) return false;
+      if (d == FlowField::kUnreachable) return true;
+      for (Snake::Direction dir :
+           {Snake::Direction::kUp, Snake::Direction::kDown,
+            Snake::Direction::kLeft, Snake::Direction::kRight}) {
+        const SDL_Point cell =
+            Neighbour(head, dir, occupancy.Width(), occupancy.Height());
+        if (!occupancy.Occupied(cell.x, cell.y) &&
+            food_field.Distance(cell.x, cell.y) < d) {
+          return false;
+        }
+      }
+      return true;
+    };
+    stale = stuck(snake) ||
+            std::any_of(agents.begin(), agents.end(),
+                        [&](AIAgent const &agent) { return stuck(agent.snake); });
+  }
+  if (stale) food_field.Compute(occupancy, food);
+}
 
-  if (start_x == goal_x && start_y == goal_y) {
-    return ai_snake.direction;
+std::chrono::steady_clock::time_point Game::ThinkDeadline() const {
+  if (think_budget.count() == 0 || recording != nullptr) {
+    return std::chrono::steady_clock::time_point::max();
   }
+  return std::chrono::steady_clock::now() + think_budget;
+}
 
-  const float INF = std::numeric_limits<float>::infinity();
-  std::vector<std::vector<float>> g_score(grid_height_, std::vector<float>(grid_width_, INF));  // Modified: Use grid_height_ and grid_width_
-  std::vector<std::vector<float>> f_score(grid_height_, std::vector<float>(grid_width_, INF));  // Modified: Use grid_height_ and grid_width_
-  std::vector<std::vector<SDL_Point>> came_from(grid_height_, std::vector<SDL_Point>(grid_width_, {-1, -1}));  // Modified: Use grid_height_ and grid_width_
+void Game::ShareThinkTime(std::chrono::steady_clock::time_point tick_deadline,
+                          std::size_t snakes, PlanningScratch &scratch) {
+  if (tick_deadline == std::chrono::steady_clock::time_point::max()) {
+    scratch.deadline = tick_deadline;
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  const auto share = static_cast<long>(std::max<std::size_t>(snakes, 1));
+  scratch.deadline = now + (tick_deadline - now) / share;
+}
 
-  auto compare = [](const std::tuple<float, int, int>& a, const std::tuple<float, int, int>& b) {
-    return std::get<0>(a) > std::get<0>(b);
-  };
-  std::priority_queue<std::tuple<float, int, int>, std::vector<std::tuple<float, int, int>>, decltype(compare)> open(compare);
+Snake::Direction Game::ComputeAIDirection(Snake const &mover,
+                                          AIMemory &memory,
+                                          PlanningScratch &scratch) const {
+  if (cycle) return CycleDirection(mover, memory.chasing, scratch);
+  if (policy == AIPolicy::kMonteCarlo) {
+    return MonteCarloDirection(mover, memory, scratch);
+  }
+  return RoomiestDirection(mover, SearchDirection(mover), scratch);
+}
 
-  g_score[start_y][start_x] = 0.0f;
-  f_score[start_y][start_x] = std::abs(start_x - goal_x) + std::abs(start_y - goal_y);
-  open.push({f_score[start_y][start_x], start_x, start_y});
+Snake::Direction Game::MonteCarloDirection(Snake const &mover,
+                                           AIMemory &memory,
+                                           PlanningScratch &scratch) const {
+  // Rollouts per candidate move, how many steps of survival one food is
+  // worth, and how many steps per rollout another move must win by on
+  // average to be taken over the food field's.
+  constexpr int kRollouts = 8;
+  constexpr int kFoodValue = SimState::kMaxSteps / 2;
+  constexpr int kMargin = 4;
+
+  const SDL_Point head = mover.HeadCell();
+  const int head_cell = occupancy.Index(head.x, head.y);
+  if (memory.decided_cell == head_cell) {
+    return RoomiestDirection(mover, memory.decision, scratch);
+  }
 
-  std::vector<std::pair<int, int>> dirs = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};  // Up, down, left, right
+  // Free moves, the food field's choice first so ties go to it.
+  const Snake::Direction greedy = SearchDirection(mover);
+  Snake::Direction candidates[4];
+  int count = 0;
+  for (Snake::Direction dir :
+       {greedy, Snake::Direction::kUp, Snake::Direction::kDown,
+        Snake::Direction::kLeft, Snake::Direction::kRight}) {
+    const SDL_Point cell =
+        Neighbour(head, dir, occupancy.Width(), occupancy.Height());
+    if (occupancy.Occupied(cell.x, cell.y) ||
+        std::find(candidates, candidates + count, dir) != candidates + count) {
+      continue;
+    }
+    candidates[count++] = dir;
+  }
 
-  while (!open.empty()) {
-    auto [cost, cx, cy] = open.top();
-    open.pop();
+  Snake::Direction best = count > 0 ? candidates[0] : mover.direction;
+  if (count > 1) {
+    // The mover and the snakes close enough to meet it within a rollout,
+    // nearest first.
+    SimState &root = scratch.root;
+    const std::uint64_t seed = (std::uint64_t{ticks} << 32) ^
+                               static_cast<std::uint64_t>(head_cell);
+    root.Reset(occupancy.OccupiedBits(),
+               food.x < 0 ? -1 : occupancy.Index(food.x, food.y), seed);
+    root.AddSnake(mover);
+    auto distance = [&](SDL_Point cell) {
+      const int dx = std::abs(cell.x - head.x);
+      const int dy = std::abs(cell.y - head.y);
+      return std::min(dx, occupancy.Width() - dx) +
+             std::min(dy, occupancy.Height() - dy);
+    };
+    auto &nearby_snakes = scratch.nearby_snakes;
+    nearby_snakes.clear();
+    auto consider = [&](Snake const &other) {
+      if (&other == &mover || !other.alive) return;
+      const int d = distance(other.HeadCell());
+      if (d <= 2 * SimState::kMaxSteps) nearby_snakes.emplace_back(d, &other);
+    };
+    consider(snake);
+    for (AIAgent const &agent : agents) consider(agent.snake);
+    std::sort(nearby_snakes.begin(), nearby_snakes.end());
+    for (const auto &other : nearby_snakes) {
+      if (!root.AddSnake(*other.second)) break;
+    }
+
+    // Obstacles move at most half as fast as snakes, so only those within a
+    // rollout's length can get in the way. Their speeds become cells per
+    // rollout step, one step being a cell of the mover's.
+    auto &nearby_obstacles = scratch.nearby_obstacles;
+    nearby_obstacles.clear();
+    const auto &xs = moving_obstacles.X();
+    const auto &ys = moving_obstacles.Y();
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+      const int d = distance({FixedCell(xs[i]), FixedCell(ys[i])});
+      if (d <= SimState::kMaxSteps) nearby_obstacles.emplace_back(d, i);
+    }
+    std::sort(nearby_obstacles.begin(), nearby_obstacles.end());
+    auto per_step = [&mover](Fixed velocity) {
+      return static_cast<Fixed>(std::int64_t{velocity} * kFixedOne /
+                                mover.speed);
+    };
+    for (const auto &obstacle : nearby_obstacles) {
+      const std::size_t i = obstacle.second;
+      if (!root.AddObstacle(xs[i], ys[i], per_step(moving_obstacles.DX()[i]),
+                            per_step(moving_obstacles.DY()[i]))) {
+        break;
+      }
+    }
 
-    if (cx == goal_x && cy == goal_y) {
-      // Reconstruct path
-      std::vector<SDL_Point> path;
-      SDL_Point current = {cx, cy};
-      while (current.x != start_x || current.y != start_y) {
-        path.push_back(current);
-        current = came_from[current.y][current.x];
+    // Every candidate plays the same random sequence in a given round, so
+    // they are compared on equal terms. Rounds go on until kRollouts are
+    // done or the deadline passes, but at least one always runs.
+    long totals[4] = {0, 0, 0, 0};
+    const bool timed =
+        scratch.deadline != std::chrono::steady_clock::time_point::max();
+    int rounds = 0;
+    while (rounds < kRollouts) {
+      for (int c = 0; c < count; ++c) {
+        scratch.work = root;
+        scratch.work.Reseed(seed + static_cast<std::uint64_t>(rounds) + 1);
+        totals[c] += scratch.work.Rollout(candidates[c], SimState::kMaxSteps,
+                                          food_field, kFoodValue);
       }
-      path.push_back({start_x, start_y});
-      std::reverse(path.begin(), path.end());
+      ++rounds;
+      if (timed && std::chrono::steady_clock::now() >= scratch.deadline) break;
+    }
+    // Rollouts are noisy, so the food field's move stands unless another
+    // is clearly better.
+    int chosen = 0;
+    for (int c = 1; c < count; ++c) {
+      if (totals[c] > totals[chosen]) chosen = c;
+    }
+    if (totals[chosen] <= totals[0] + long{kMargin} * rounds) chosen = 0;
+    best = candidates[chosen];
+  }
 
-      if (path.size() < 2) return ai_snake.direction;
-      SDL_Point next = path[1];
+  memory.decided_cell = head_cell;
+  memory.decision = best;
+  return RoomiestDirection(mover, best, scratch);
+}
 
-      if (next.x > start_x) return Snake::Direction::kRight;
-      if (next.x < start_x) return Snake::Direction::kLeft;
-      if (next.y > start_y) return Snake::Direction::kDown;
-      if (next.y < start_y) return Snake::Direction::kUp;
+Snake::Direction Game::SearchDirection(Snake const &mover) const {
+  const SDL_Point head = mover.HeadCell();
+  // No food or no way to it: keep current direction. Ties go to the current
+  // direction too, so snakes don't zigzag along equally short paths.
+  Snake::Direction best = mover.direction;
+  int best_distance = FlowField::kUnreachable;
+  if (food.x < 0) return best;
+  for (Snake::Direction dir :
+       {mover.direction, Snake::Direction::kUp, Snake::Direction::kDown,
+        Snake::Direction::kLeft, Snake::Direction::kRight}) {
+    const SDL_Point cell =
+        Neighbour(head, dir, occupancy.Width(), occupancy.Height());
+    if (occupancy.Occupied(cell.x, cell.y)) continue;
+    const int d = food_field.Distance(cell.x, cell.y);
+    if (d < best_distance) {
+      best = dir;
+      best_distance = d;
+    }
+  }
+  return best;
+}
 
-      return ai_snake.direction;
+Snake::Direction Game::CycleDirection(Snake const &mover, SDL_Point &chasing,
+                                      PlanningScratch &scratch) const {
+  // Cells a shortcut must leave between itself and the tail, for the growth
+  // from food eaten on the way.
+  constexpr int kShortcutSlack = 4;
+
+  const SDL_Point head = mover.HeadCell();
+  const int head_cell = occupancy.Index(head.x, head.y);
+  const int n = cycle->Size();
+  // Every move keeps the body in cycle order behind the head, so the cells
+  // from the head forward to the tail are free of it.
+  const int tail_cell = mover.body.size() == 0
+                            ? head_cell
+                            : occupancy.Index(mover.body.front().x,
+                                              mover.body.front().y);
+  const int room =
+      tail_cell == head_cell ? n : cycle->Distance(head_cell, tail_cell);
+  const int to_food =
+      food.x < 0 ? n
+                 : cycle->Distance(head_cell, occupancy.Index(food.x, food.y));
+  // Past half the board, skipped cells are too likely to be needed later.
+  const bool shortcuts = mover.size * 2 < n;
+
+  // Without shortcuts the next cell of the cycle beats every other move
+  // whenever it is free, so it is read straight off the table.
+  if (!shortcuts && room > 1) {
+    const int next = cycle->Next(head_cell);
+    if (!occupancy.Occupied(next)) {
+      for (Snake::Direction dir :
+           {Snake::Direction::kUp, Snake::Direction::kDown,
+            Snake::Direction::kLeft, Snake::Direction::kRight}) {
+        const SDL_Point cell =
+            Neighbour(head, dir, occupancy.Width(), occupancy.Height());
+        if (occupancy.Index(cell.x, cell.y) == next) return dir;
+      }
     }
+  }
 
-    for (auto [dx, dy] : dirs) {
-      int nx = cx + dx;
-      int ny = cy + dy;
-      if (nx < 0 || nx >= static_cast<int>(grid_width_) || ny < 0 || ny >= static_cast<int>(grid_height_)) continue;  // Modified: Use grid_width_ and grid_height_
-      if (IsBlocked(nx, ny)) continue;
+  // Food sitting just past an obstacle on the cycle can only be reached in
+  // cycle order by passing it first, every lap. Such food is chased down the
+  // food field instead until it is eaten.
+  if (shortcuts && food.x >= 0 && chasing.x == food.x && chasing.y == food.y) {
+    return RoomiestDirection(mover, SearchDirection(mover), scratch);
+  }
 
-      float tentative_g = g_score[cy][cx] + 1.0f;
-      if (tentative_g < g_score[ny][nx]) {
-        came_from[ny][nx] = {cx, cy};
-        g_score[ny][nx] = tentative_g;
-        f_score[ny][nx] = tentative_g + std::abs(nx - goal_x) + std::abs(ny - goal_y);
-        open.push({f_score[ny][nx], nx, ny});
-      }
+  // Jumps ahead that don't pass the food rank above everything else, the
+  // longest first; then the shortest move, so obstacles on the cycle are
+  // stepped around rather than skipped past. A jump of more than half the
+  // cycle is really a step back, and taking it after stepping around an
+  // obstacle would loop forever.
+  bool found = false;
+  Snake::Direction best = mover.direction;
+  int best_rank = 0;
+  for (Snake::Direction dir :
+       {Snake::Direction::kUp, Snake::Direction::kDown,
+        Snake::Direction::kLeft, Snake::Direction::kRight}) {
+    const SDL_Point cell =
+        Neighbour(head, dir, occupancy.Width(), occupancy.Height());
+    if (occupancy.Occupied(cell.x, cell.y)) continue;
+    const int ahead = cycle->Distance(head_cell, occupancy.Index(cell.x, cell.y));
+    if (ahead == 0 || ahead >= room) continue;
+    if (ahead > 1 && ahead + kShortcutSlack >= room) continue;
+    const bool shortcut = shortcuts && ahead <= to_food && ahead * 2 <= n;
+    const int rank = shortcut ? n + ahead : n - ahead;
+    if (!found || rank > best_rank) {
+      found = true;
+      best = dir;
+      best_rank = rank;
     }
   }
+  if (shortcuts && food.x >= 0 && (!found || best_rank <= n)) {
+    chasing = food;
+    return RoomiestDirection(mover, SearchDirection(mover), scratch);
+  }
+  // Boxed in by other snakes or obstacles: just look for space.
+  if (!found) return RoomiestDirection(mover, mover.direction, scratch);
+  return best;
+}
 
-  // No path found, keep current direction
-  return ai_snake.direction;
-}
\ No newline at end of file
+Snake::Direction Game::RoomiestDirection(Snake const &mover,
+                                         Snake::Direction preferred,
+                                         PlanningScratch &scratch) const {
+  const SDL_Point start = mover.HeadCell();
+  // Only take the preferred move if it leads somewhere with room for the
+  // whole body; otherwise head for whichever move leaves the most space. The
+  // flood fill stops as soon as there is enough room, so safe moves stay
+  // cheap.
+  const std::size_t room = static_cast<std::size_t>(mover.size) + 1;
+  auto space = [&](Snake::Direction dir) {
+    SDL_Point cell = Neighbour(start, dir, occupancy.Width(),
+                               occupancy.Height());
+    return Bitboard::CountReachable(occupancy.OccupiedBits(), cell.x, cell.y,
+                                    room, scratch.reach, scratch.spare);
+  };
+  std::size_t best_space = space(preferred);
+  if (best_space >= room) return preferred;
+
+  Snake::Direction best = preferred;
+  for (Snake::Direction dir :
+       {Snake::Direction::kUp, Snake::Direction::kDown,
+        Snake::Direction::kLeft, Snake::Direction::kRight}) {
+    if (dir == preferred ||
+        (mover.size > 1 && Opposite(dir, mover.direction))) {
+      continue;
+    }
+    const std::size_t dir_space = space(dir);
+    if (dir_space > best_space) {
+      best = dir;
+      best_space = dir_space;
+    }
+  }
+  return best;
+}
@@ -1,43 +1,176 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <random>
 #include <string>  // Added
 #include <map>     // Added
+#include <memory>
+#include <vector>
 #include "SDL.h"
 #include "controller.h"
-#include "snake.h"  // Moved up for Snake::Direction in MovingObstacle
-
-// Added: Moved struct outside Game class for visibility in renderer.h
-struct MovingObstacle {
-  float x;
-  float y;
-  Snake::Direction dir;
-  float speed{0.05f};  // Slower than snake's initial 0.1f
-};
+#include "flow_field.h"
+#include "frame_snapshot.h"
+#include "hamiltonian_cycle.h"
+#include "input_script.h"
+#include "obstacles.h"
+#include "occupancy_grid.h"
+#include "renderer.h"
+#include "sim_state.h"
+#include "snake.h"
+#include "triple_buffer.h"
 
-#include "renderer.h"  // Include after struct definition to avoid issues
+class FrameProfiler;
+class Replay;
+class ThreadPool;
 
 class Game {
  public:
+  // How computer-steered snakes, including the headless autopilot, move.
+  enum class AIPolicy {
+    kSearch,  // Shortest path to the food, checked for room by a flood fill
+    kCycle,   // Along a Hamiltonian cycle, with safe shortcuts to the food
+    kMonteCarlo,  // Whichever move scores best over random rollouts
+  };
+  // Reads a policy's command-line name into `policy`; false for an unknown
+  // name.
+  static bool ParsePolicy(const char *name, AIPolicy &policy);
+  // Every policy name, joined by '|', for usage messages.
+  static std::string PolicyNames();
+
+  // Fixed obstacles placed at the start of every game, board permitting.
+  static constexpr std::size_t kFixedObstacles = 5;
+
   Game(std::size_t grid_width, std::size_t grid_height);
+  // Seeded games are fully deterministic and share no state with each other,
+  // so any number of them can run side by side. `ai_snakes` computer-steered
+  // snakes compete with the player among `hazards` moving obstacles.
+  Game(std::size_t grid_width, std::size_t grid_height, std::uint32_t seed,
+       std::size_t ai_snakes = 1, std::size_t hazards = 3,
+       AIPolicy policy = AIPolicy::kSearch);
+  // Spreads AI path planning over `pool`, which must outlive the game's runs.
+  // Without one, agents plan on the simulating thread. Results are the same
+  // either way.
+  void SetPlanningPool(ThreadPool *pool);
+  // Interactive loop. The simulation runs on its own thread at a fixed
+  // `ticks_per_second`, publishing a snapshot after every change; the calling
+  // thread handles input and draws the latest snapshot at up to
+  // `frames_per_second`, interpolating between the last two steps.
   void Run(Controller const &controller, Renderer &renderer,
-           std::size_t target_frame_duration);
+           std::size_t ticks_per_second, std::size_t frames_per_second);
+  // Runs the simulation without a window or frame delay until the player
+  // dies or `max_ticks` ticks have elapsed. The player follows `script` when
+  // one is given, otherwise it is steered like the AI snakes. Returns the
+  // wall-clock time spent, in seconds.
+  double RunHeadless(Controller const &controller, std::size_t max_ticks,
+                     InputScript *script);
+  // Caps the time AIPolicy::kMonteCarlo spends on rollouts each tick, shared
+  // among the AI snakes; the headless autopilot gets the same again. Zero,
+  // the default, leaves only the fixed number of rollouts per move. How many
+  // rollouts fit in a budget depends on the machine, so it is ignored while
+  // recording to keep replays exact.
+  void SetThinkBudget(std::chrono::microseconds budget);
+  // Times the phases of Run() and Update() into `profiler` (not owned), which
+  // F3 then shows over the board. Null turns profiling off.
+  void SetProfiler(FrameProfiler *profiler);
+  // While set, every command that changes the player's direction is appended
+  // to `replay`, stamped with the tick it was applied before. Null stops.
+  void RecordTo(Replay *replay);
+  // Applies one input command as if it had come from the keyboard.
+  void Apply(Controller const &controller, InputCommand command);
+  // Advances the simulation by one tick.
+  void Update();
+  bool IsOver() const { return game_over; }
+  // Reads highscore.txt. Only interactive games touch the file; Run() writes
+  // it back when the player enters a name.
+  void LoadHighScores();
   int GetScore() const;
   int GetSize() const;
+  int GetAIScore() const;  // Best score among the AI snakes
+  std::size_t GetTicks() const;
+  // Copies the drawable state into `out`, reusing its buffers.
+  void Snapshot(FrameSnapshot &out) const;
+
+  // Everything Update() reads or changes at one tick, for rewinding. Snake
+  // bodies are kept at their actual length and the planning scratch is left
+  // out, so on a big board it is a small fraction of a copy of the game.
+  class Checkpoint;
+  Checkpoint Save() const;
+  // Puts the game back as it was when `checkpoint` was saved. It must come
+  // from a game started with the same settings.
+  void Restore(Checkpoint const &checkpoint);
 
  private:
+  // What a computer-steered snake carries from one tick to the next.
+  struct AIMemory {
+    SDL_Point chasing{-1, -1};  // Food chased off the cycle
+    int decided_cell{-1};       // Head cell of the last rollout decision
+    Snake::Direction decision{Snake::Direction::kUp};
+  };
+
+  // A computer-steered snake and its score.
+  struct AIAgent {
+    AIAgent(std::size_t grid_width, std::size_t grid_height)
+        : snake(grid_width, grid_height, OccupancyGrid::kAIBody) {}
+
+    Snake snake;
+    AIMemory memory;
+    int score{0};
+  };
+
+  // Working space of one planning task: boards for flood fills, the states
+  // rollouts start from and run in, the snakes and obstacles near the
+  // current snake, and when the task must stop rolling out for it.
+  struct PlanningScratch {
+    PlanningScratch(std::size_t grid_width, std::size_t grid_height)
+        : reach(grid_width, grid_height),
+          spare(grid_width, grid_height),
+          root(grid_width, grid_height),
+          work(grid_width, grid_height) {}
+
+    // Makes room in the nearby lists for every snake and obstacle, so
+    // planning never allocates. Copies don't keep it.
+    void Reserve(std::size_t snakes, std::size_t obstacles) {
+      nearby_snakes.reserve(snakes);
+      nearby_obstacles.reserve(obstacles);
+    }
+
+    Bitboard reach;
+    Bitboard spare;
+    SimState root;
+    SimState work;
+    // (distance, snake) and (distance, obstacle index) pairs
+    std::vector<std::pair<int, Snake const *>> nearby_snakes;
+    std::vector<std::pair<int, std::size_t>> nearby_obstacles;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
   Snake snake;
-  Snake ai_snake;  // Added: AI-controlled snake
+  std::vector<AIAgent> agents;
   SDL_Point food;
+  OccupancyGrid occupancy;  // Snake bodies and obstacles, one byte per cell
+  // Distances to the food, read by every computer-steered snake; brought up
+  // to date by RefreshFoodField() before they plan.
+  FlowField food_field;
+
+  // Scratch space, one per concurrent planning task, and the pool those
+  // tasks run on (not owned; null plans on the calling thread).
+  std::vector<PlanningScratch> planning_scratch;
+  ThreadPool *planning_pool{nullptr};
+  AIPolicy policy;
+  std::chrono::microseconds think_budget{0};
+  Replay *recording{nullptr};  // Not owned
+  FrameProfiler *profiler{nullptr};  // Not owned
+  // Built once for AIPolicy::kCycle and shared by copies of the game; null
+  // under kSearch or on boards without a cycle, which fall back to search.
+  std::shared_ptr<const HamiltonianCycle> cycle;
 
-  std::random_device dev;
   std::mt19937 engine;
-  std::uniform_int_distribution<int> random_w;
-  std::uniform_int_distribution<int> random_h;
 
   int score{0};
-  int ai_score{0};  // Added: Score for AI snake
+  std::size_t ticks{0};  // Simulation steps taken so far
   bool paused{false};
 
   // Added
@@ -47,20 +180,83 @@ class Game {
   int global_high_score{0};
   std::string global_high_name;
 
-  // Added: For obstacles (updated to use non-nested MovingObstacle)
+  // Added: For obstacles
   std::vector<SDL_Point> fixed_obstacles;
-  std::vector<MovingObstacle> moving_obstacles;
+  MovingObstacles moving_obstacles;
   bool IsObstacle(int x, int y) const;
-  bool IsBlocked(int x, int y) const;  // Added: For A* to check blocked cells
 
   // Added: Grid dimensions as members
   std::size_t grid_width_;
   std::size_t grid_height_;
 
+  // Picks a uniformly random unoccupied cell; false when there is none.
+  bool RandomFreeCell(int &x, int &y);
   void PlaceFood();
-  void Update();
+  // Sets every live AI snake's direction for this tick.
+  void PlanAgents();
+  // Recomputes food_field when the food has moved, or when the board has
+  // changed and some snake's head is unreachable on the field or no longer
+  // has a free neighbour closer to the food than itself. Otherwise the field
+  // is left as it is: cells occupied since only matter once a snake runs
+  // into them, and cells freed since only mean a shorter path goes unused
+  // for a while, as every head still has a way towards the food.
+  void RefreshFoodField();
+  // Body of the simulation thread started by Run().
+  void Simulate(Controller const &controller, InputQueue &commands,
+                TripleBuffer<FrameSnapshot> &frames,
+                std::atomic<bool> const &simulating,
+                std::size_t ticks_per_second);
   void SaveHighScore();  // Added
-  Snake::Direction ComputeAIDirection();  // Added: A* for AI direction
+  // Added: Direction for `mover` under the game's AI policy. Only reads
+  // shared state (`memory` belongs to the mover), so agents can be planned
+  // concurrently.
+  Snake::Direction ComputeAIDirection(Snake const &mover, AIMemory &memory,
+                                      PlanningScratch &scratch) const;
+  // When rollouts for this tick must stop: the think budget from now, or
+  // never when there is no budget or the game is being recorded.
+  std::chrono::steady_clock::time_point ThinkDeadline() const;
+  // Sets `scratch`'s rollout deadline to an even share of the time left
+  // before `tick_deadline` among `snakes` snakes still to plan.
+  static void ShareThinkTime(std::chrono::steady_clock::time_point tick_deadline,
+                             std::size_t snakes, PlanningScratch &scratch);
+  // The move onto `mover`'s free neighbour closest to the food, or its
+  // current direction when the food can't be reached.
+  Snake::Direction SearchDirection(Snake const &mover) const;
+  // The next cell of the cycle, or the neighbour furthest ahead on it that
+  // neither passes the food nor catches up with `mover`'s tail. Food the
+  // cycle can't get to is recorded in `chasing` and searched for instead.
+  Snake::Direction CycleDirection(Snake const &mover, SDL_Point &chasing,
+                                  PlanningScratch &scratch) const;
+  // Rolls out every free move from `mover`'s head, against the nearest other
+  // snakes and moving obstacles, and takes the food field's move unless
+  // another has a clearly better total. Decides once per cell, remembering
+  // the choice in `memory`.
+  Snake::Direction MonteCarloDirection(Snake const &mover, AIMemory &memory,
+                                       PlanningScratch &scratch) const;
+  // `preferred` if it leaves room for `mover`'s whole body, otherwise the
+  // move with the most reachable space.
+  Snake::Direction RoomiestDirection(Snake const &mover,
+                                     Snake::Direction preferred,
+                                     PlanningScratch &scratch) const;
+};
+
+class Game::Checkpoint {
+ private:
+  friend class Game;
+  explicit Checkpoint(Game const &game);
+
+  std::vector<Snake> snakes;  // The player, then the AI snakes
+  std::vector<AIMemory> memories;
+  std::vector<int> ai_scores;
+  SDL_Point food;
+  OccupancyGrid occupancy;
+  FlowField food_field;
+  MovingObstacles moving_obstacles;
+  std::mt19937 engine;
+  int score;
+  std::size_t ticks;
+  bool paused;
+  bool game_over;
 };
 
 #endif
\ No newline at end of file
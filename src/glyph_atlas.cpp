@@ -0,0 +1,135 @@
+#include "glyph_atlas.h"
+#include <algorithm>
+#include <iostream>
+
+GlyphAtlas::GlyphAtlas(SDL_Renderer *renderer, TTF_Font *font)
+    : renderer(renderer) {
+  if (renderer == nullptr || font == nullptr) return;
+
+  // Rasterise each glyph on its own first to learn its size. A one-character
+  // TTF_RenderText surface is exactly one advance wide, bearing included.
+  constexpr int kCount = kLast - kFirst + 1;
+  SDL_Surface *surfaces[kCount] = {};
+  int x = 0;
+  int y = 0;
+  int row_height = 0;
+  bool ok = true;
+  for (int i = 0; i < kCount && ok; ++i) {
+    const char text[2] = {static_cast<char>(kFirst + i), '\0'};
+    surfaces[i] = TTF_RenderText_Solid(font, text, SDL_Color{255, 255, 255, 255});
+    if (surfaces[i] == nullptr) {
+      ok = false;
+      break;
+    }
+    // Simple shelf packing: left to right, new row when the width runs out.
+    if (x + surfaces[i]->w > kAtlasWidth) {
+      x = 0;
+      y += row_height;
+      row_height = 0;
+    }
+    glyphs[i].source = {x, y, surfaces[i]->w, surfaces[i]->h};
+    x += surfaces[i]->w;
+    row_height = std::max(row_height, surfaces[i]->h);
+  }
+
+  SDL_Surface *atlas = nullptr;
+  if (ok) {
+    atlas_width = kAtlasWidth;
+    atlas_height = y + row_height;
+    atlas = SDL_CreateRGBSurfaceWithFormat(0, atlas_width, atlas_height, 32,
+                                           SDL_PIXELFORMAT_RGBA32);
+    ok = atlas != nullptr;
+  }
+  for (int i = 0; i < kCount && ok; ++i) {
+    // The new surface is fully transparent; the glyph blit keeps its
+    // colour key, so only the glyph's own pixels land in the atlas.
+    ok = SDL_BlitSurface(surfaces[i], nullptr, atlas, &glyphs[i].source) == 0;
+  }
+  if (ok) {
+    texture = SDL_CreateTextureFromSurface(renderer, atlas);
+    if (texture != nullptr) {
+      SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    }
+  }
+  if (texture == nullptr) {
+    std::cerr << "Failed to build glyph atlas.\n";
+    std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
+  }
+
+  for (SDL_Surface *surface : surfaces) {
+    if (surface != nullptr) SDL_FreeSurface(surface);
+  }
+  if (atlas != nullptr) SDL_FreeSurface(atlas);
+}
+
+GlyphAtlas::~GlyphAtlas() {
+  if (texture != nullptr) SDL_DestroyTexture(texture);
+}
+
+int GlyphAtlas::TextWidth(std::string_view text) const {
+  int width = 0;
+  for (char c : text) {
+    if (c < kFirst || c > kLast) continue;
+    width += glyphs[c - kFirst].source.w;
+  }
+  return width;
+}
+
+void GlyphAtlas::Queue(std::string_view text, int x, int y, SDL_Color color,
+                       bool center, float scale) {
+  if (!Valid() || text.empty()) return;
+  if (center) x -= static_cast<int>(TextWidth(text) * scale) / 2;
+
+  // Positions are accumulated unrounded so scaled text doesn't drift.
+  float left = static_cast<float>(x);
+  for (char c : text) {
+    if (c < kFirst || c > kLast) continue;
+    const SDL_Rect &source = glyphs[c - kFirst].source;
+    const int dest_x = static_cast<int>(left);
+    left += source.w * scale;
+    quads.push_back({source,
+                     {dest_x, y, static_cast<int>(left) - dest_x,
+                      static_cast<int>(source.h * scale)},
+                     color});
+  }
+}
+
+void GlyphAtlas::Flush() {
+  if (quads.empty()) return;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  // Every quad goes out in one textured, per-vertex coloured draw call.
+  const float u_scale = 1.0f / atlas_width;
+  const float v_scale = 1.0f / atlas_height;
+  vertices.clear();
+  indices.clear();
+  for (const Quad &quad : quads) {
+    const float left = static_cast<float>(quad.dest.x);
+    const float top = static_cast<float>(quad.dest.y);
+    const float right = left + quad.dest.w;
+    const float bottom = top + quad.dest.h;
+    const float u0 = quad.source.x * u_scale;
+    const float v0 = quad.source.y * v_scale;
+    const float u1 = (quad.source.x + quad.source.w) * u_scale;
+    const float v1 = (quad.source.y + quad.source.h) * v_scale;
+
+    const int base = static_cast<int>(vertices.size());
+    vertices.push_back({{left, top}, quad.color, {u0, v0}});
+    vertices.push_back({{right, top}, quad.color, {u1, v0}});
+    vertices.push_back({{right, bottom}, quad.color, {u1, v1}});
+    vertices.push_back({{left, bottom}, quad.color, {u0, v1}});
+    for (int corner : {0, 1, 2, 0, 2, 3}) {
+      indices.push_back(base + corner);
+    }
+  }
+  SDL_RenderGeometry(renderer, texture, vertices.data(),
+                     static_cast<int>(vertices.size()), indices.data(),
+                     static_cast<int>(indices.size()));
+#else
+  // No geometry API before SDL 2.0.18: one copy per glyph instead.
+  for (const Quad &quad : quads) {
+    SDL_SetTextureColorMod(texture, quad.color.r, quad.color.g, quad.color.b);
+    SDL_RenderCopy(renderer, texture, &quad.source, &quad.dest);
+  }
+#endif
+  quads.clear();
+}
@@ -0,0 +1,64 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <string_view>
+#include <vector>
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+// Printable ASCII rasterised once into a single texture. Text is then laid
+// out as textured quads from that atlas: strings queued during a frame are
+// submitted together by Flush(), so drawing text allocates nothing and does
+// no font rasterisation per frame.
+class GlyphAtlas {
+ public:
+  // Glyphs are rendered in white and tinted per quad. Leaves the atlas empty
+  // (Valid() == false) if any SDL call fails.
+  GlyphAtlas(SDL_Renderer *renderer, TTF_Font *font);
+  ~GlyphAtlas();
+
+  GlyphAtlas(const GlyphAtlas &) = delete;
+  GlyphAtlas &operator=(const GlyphAtlas &) = delete;
+
+  bool Valid() const { return texture != nullptr; }
+
+  // Queues `text` with its top edge at y, starting at x or, when `center` is
+  // set, centred on x, drawn at `scale` times the font size. Characters
+  // outside printable ASCII are skipped.
+  void Queue(std::string_view text, int x, int y, SDL_Color color,
+             bool center, float scale = 1.0f);
+  // Draws everything queued since the last flush.
+  void Flush();
+
+ private:
+  static constexpr char kFirst = ' ';
+  static constexpr char kLast = '~';
+  static constexpr int kAtlasWidth = 1024;
+
+  struct Glyph {
+    SDL_Rect source;  // Location in the atlas; w is also the advance
+  };
+
+  int TextWidth(std::string_view text) const;
+
+  SDL_Renderer *renderer;
+  SDL_Texture *texture{nullptr};
+  int atlas_width{0};
+  int atlas_height{0};
+  Glyph glyphs[kLast - kFirst + 1];
+
+  struct Quad {
+    SDL_Rect source;
+    SDL_Rect dest;
+    SDL_Color color;
+  };
+
+  // Per-frame buffers, reused across frames.
+  std::vector<Quad> quads;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  std::vector<SDL_Vertex> vertices;
+  std::vector<int> indices;
+#endif
+};
+
+#endif
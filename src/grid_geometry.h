@@ -0,0 +1,96 @@
+#ifndef GRID_GEOMETRY_H
+#define GRID_GEOMETRY_H
+
+#include <utility>
+
+// Cell arithmetic on a wrapping board, for loops that run once per cell or
+// per step. RuntimeGrid works on any board. FixedGrid<W, H> has the sizes as
+// constants, so splitting a cell index into (x, y) compiles to a shift and a
+// mask on power-of-two boards instead of a division. Hot loops are written
+// once as templates over the geometry and entered through DispatchGrid(),
+// which picks a FixedGrid for the common board sizes.
+class RuntimeGrid {
+ public:
+  RuntimeGrid(int width, int height) : width(width), height(height) {}
+
+  int Width() const { return width; }
+  int Height() const { return height; }
+  int Index(int x, int y) const { return y * width + x; }
+  int X(int cell) const { return cell % width; }
+  int Y(int cell) const { return cell / width; }
+
+  // The four neighbours of `cell`, wrapping at the edges.
+  int Left(int cell) const {
+    return X(cell) == 0 ? cell + width - 1 : cell - 1;
+  }
+  int Right(int cell) const {
+    return X(cell) == width - 1 ? cell - width + 1 : cell + 1;
+  }
+  int Up(int cell) const {
+    return cell < width ? cell + width * (height - 1) : cell - width;
+  }
+  int Down(int cell) const {
+    return cell >= width * (height - 1) ? cell - width * (height - 1)
+                                        : cell + width;
+  }
+
+ private:
+  int width;
+  int height;
+};
+
+template <int W, int H>
+class FixedGrid {
+ public:
+  static_assert(W > 0 && H > 0, "a board needs at least one cell");
+
+  static constexpr int Width() { return W; }
+  static constexpr int Height() { return H; }
+  static constexpr int Index(int x, int y) { return y * W + x; }
+  // Cells are never negative; unsigned arithmetic lets the compiler drop
+  // the sign fix-ups and use a mask and a shift for power-of-two widths.
+  static constexpr int X(int cell) {
+    return static_cast<int>(static_cast<unsigned>(cell) % W);
+  }
+  static constexpr int Y(int cell) {
+    return static_cast<int>(static_cast<unsigned>(cell) / W);
+  }
+
+  static constexpr int Left(int cell) {
+    return X(cell) == 0 ? cell + W - 1 : cell - 1;
+  }
+  static constexpr int Right(int cell) {
+    return X(cell) == W - 1 ? cell - W + 1 : cell + 1;
+  }
+  static constexpr int Up(int cell) {
+    return cell < W ? cell + W * (H - 1) : cell - W;
+  }
+  static constexpr int Down(int cell) {
+    return cell >= W * (H - 1) ? cell - W * (H - 1) : cell + W;
+  }
+};
+
+// Calls `body` with the geometry of a `width` x `height` board: a FixedGrid
+// for the default 32x32 board and the larger square powers of two, a
+// RuntimeGrid otherwise. Each size listed here costs one more copy of every
+// dispatched loop.
+template <typename Body>
+decltype(auto) DispatchGrid(int width, int height, Body &&body) {
+  if (width == height) {
+    switch (width) {
+      case 32:
+        return std::forward<Body>(body)(FixedGrid<32, 32>());
+      case 64:
+        return std::forward<Body>(body)(FixedGrid<64, 64>());
+      case 128:
+        return std::forward<Body>(body)(FixedGrid<128, 128>());
+      case 256:
+        return std::forward<Body>(body)(FixedGrid<256, 256>());
+      case 512:
+        return std::forward<Body>(body)(FixedGrid<512, 512>());
+    }
+  }
+  return std::forward<Body>(body)(RuntimeGrid(width, height));
+}
+
+#endif
@@ -0,0 +1,58 @@
+#include "hamiltonian_cycle.h"
+#include <utility>
+
+namespace {
+
+// The tour as a list of (column, row) pairs on a board `columns` wide and
+// `rows` high, where rows >= 2 and, for odd rows, columns >= 3.
+std::vector<std::pair<int, int>> Tour(int columns, int rows) {
+  const int even_rows = rows - rows % 2;
+  std::vector<std::pair<int, int>> tour;
+  tour.reserve(static_cast<std::size_t>(columns) * rows);
+
+  // Row 0 left to right, then rows 1 .. even_rows - 1 back and forth over
+  // columns 1 and up, ending on column 1 of an odd row.
+  for (int c = 0; c < columns; ++c) tour.emplace_back(c, 0);
+  for (int r = 1; r < even_rows; ++r) {
+    const bool leftwards = r % 2 == 1;
+    for (int i = 1; i < columns; ++i) {
+      const int c = leftwards ? columns - i : i;
+      // The odd last row is visited in full between columns 2 and 1 of the
+      // row above it: down, rightwards through the wrap-around, and back up.
+      if (rows % 2 == 1 && r == even_rows - 1 && c == 1) {
+        for (int j = 2; j < columns + 2; ++j) {
+          tour.emplace_back(j % columns, rows - 1);
+        }
+      }
+      tour.emplace_back(c, r);
+    }
+  }
+  // Back up column 0 to where the tour started.
+  for (int r = even_rows - 1; r >= 1; --r) tour.emplace_back(0, r);
+  return tour;
+}
+
+}  // namespace
+
+HamiltonianCycle::HamiltonianCycle(std::size_t width, std::size_t height) {
+  const int w = static_cast<int>(width);
+  const int h = static_cast<int>(height);
+  if (w < 2 || h < 2) return;
+
+  // Odd heights need at least three columns; a board two wide and odd high
+  // is toured sideways instead.
+  const bool sideways = h % 2 == 1 && (w < 3 || w % 2 == 0);
+  const auto tour = sideways ? Tour(h, w) : Tour(w, h);
+
+  next.resize(tour.size());
+  position.resize(tour.size());
+  auto index = [&](std::pair<int, int> cell) {
+    return sideways ? cell.first * w + cell.second
+                    : cell.second * w + cell.first;
+  };
+  for (std::size_t i = 0; i < tour.size(); ++i) {
+    const int cell = index(tour[i]);
+    position[cell] = static_cast<int>(i);
+    next[cell] = index(tour[(i + 1) % tour.size()]);
+  }
+}
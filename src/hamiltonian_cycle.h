@@ -0,0 +1,36 @@
+#ifndef HAMILTONIAN_CYCLE_H
+#define HAMILTONIAN_CYCLE_H
+
+#include <cstddef>
+#include <vector>
+
+// A closed tour through every cell of the board, built once and stored as two
+// flat tables indexed by cell (y * width + x): the next cell on the tour and
+// each cell's position along it. A snake that follows the tour can never trap
+// itself, and the positions let it check in O(1) whether jumping ahead to a
+// neighbouring cell keeps its body in tour order.
+//
+// The tour snakes back and forth along the rows and returns up column 0, which
+// needs an even number of rows. With an odd number it runs through the last
+// row using the wrap-around edge, as the snakes can. Boards with a side shorter
+// than 2 have no tour.
+class HamiltonianCycle {
+ public:
+  HamiltonianCycle(std::size_t width, std::size_t height);
+
+  bool Valid() const { return !next.empty(); }
+  int Size() const { return static_cast<int>(next.size()); }
+  int Next(int cell) const { return next[cell]; }
+  int Position(int cell) const { return position[cell]; }
+  // Steps along the tour from cell `from` to cell `to`, in [0, Size()).
+  int Distance(int from, int to) const {
+    const int d = position[to] - position[from];
+    return d < 0 ? d + Size() : d;
+  }
+
+ private:
+  std::vector<int> next;
+  std::vector<int> position;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#include "input_script.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool InputScript::Load(const std::string &path) {
+  entries.clear();
+  cursor = 0;
+
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "Could not open input script " << path << "\n";
+    return false;
+  }
+
+  std::string line;
+  int line_number = 0;
+  while (std::getline(in, line)) {
+    ++line_number;
+    if (line.empty() || line[0] == '#') continue;
+
+    std::istringstream fields(line);
+    std::size_t tick;
+    char dir;
+    if (!(fields >> tick >> dir) ||
+        (!entries.empty() && tick < entries.back().tick)) {
+      std::cerr << path << ":" << line_number << ": bad script entry\n";
+      entries.clear();
+      return false;
+    }
+
+    Snake::Direction direction;
+    switch (dir) {
+      case 'U':
+        direction = Snake::Direction::kUp;
+        break;
+      case 'D':
+        direction = Snake::Direction::kDown;
+        break;
+      case 'L':
+        direction = Snake::Direction::kLeft;
+        break;
+      case 'R':
+        direction = Snake::Direction::kRight;
+        break;
+      default:
+        std::cerr << path << ":" << line_number << ": bad direction\n";
+        entries.clear();
+        return false;
+    }
+    entries.push_back({tick, direction});
+  }
+  return true;
+}
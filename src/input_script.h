@@ -0,0 +1,40 @@
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "snake.h"
+
+// Tick-stamped direction changes for the player snake, used to drive headless
+// runs. The text format is one "<tick> <U|D|L|R>" pair per line, ticks in
+// ascending order; blank lines and lines starting with '#' are ignored.
+class InputScript {
+ public:
+  // Returns false (leaving the script empty) if the file can't be read or a
+  // line is malformed.
+  bool Load(const std::string &path);
+
+  // Calls `apply` for every entry stamped with `tick`. Ticks must be visited
+  // in ascending order.
+  template <typename Apply>
+  void Play(std::size_t tick, Apply apply) {
+    while (cursor < entries.size() && entries[cursor].tick <= tick) {
+      if (entries[cursor].tick == tick) apply(entries[cursor].direction);
+      ++cursor;
+    }
+  }
+
+  bool Empty() const { return entries.empty(); }
+
+ private:
+  struct Entry {
+    std::size_t tick;
+    Snake::Direction direction;
+  };
+
+  std::vector<Entry> entries;
+  std::size_t cursor{0};
+};
+
+#endif
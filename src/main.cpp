@@ -1,22 +1,232 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include "SDL.h"
 #include "controller.h"
+#include "fixed_point.h"
+#include "frame_profiler.h"
+#include "frame_snapshot.h"
 #include "game.h"
+#include "input_script.h"
 #include "renderer.h"
+#include "replay.h"
+#include "thread_pool.h"
 
-int main() {
-  constexpr std::size_t kFramesPerSecond{60};
-  constexpr std::size_t kMsPerFrame{1000 / kFramesPerSecond};
-  constexpr std::size_t kScreenWidth{640};
-  constexpr std::size_t kScreenHeight{640};
-  constexpr std::size_t kGridWidth{32};
-  constexpr std::size_t kGridHeight{32};
+namespace {
+
+constexpr std::size_t kScreenWidth{640};
+constexpr std::size_t kScreenHeight{640};
+
+void PrintUsage(const char *program) {
+  std::cerr << "Usage: " << program
+            << " [--ai N] [--hazards N] [--policy "
+            << Game::PolicyNames() << "]"
+               " [--think-us N] [--grid W H] [--seed N] [--record FILE]"
+               " [--trace FILE]"
+               " [--headless [--ticks N] [--script FILE]]\n"
+               "       "
+            << program << " --replay FILE [--seek TICK] [--render]\n";
+}
+
+// Plays a recorded game back at full speed from `seek_tick` on. With
+// `render`, every tick is drawn; the left and right arrows jump back and
+// forward, ESC pauses and q or closing the window quits.
+int PlayReplay(const std::string &path, std::size_t seek_tick, bool render) {
+  constexpr std::size_t kJumpTicks{600};
+
+  Replay replay;
+  if (!replay.Load(path)) {
+    return 1;
+  }
+  Controller controller;
+  ReplayPlayer player(replay, controller);
+  std::unique_ptr<ThreadPool> planning_pool;
+  if (replay.ai_snakes > 1) {
+    planning_pool = std::make_unique<ThreadPool>();
+    player.SetPlanningPool(planning_pool.get());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  player.Seek(seek_tick);
+  if (!render) {
+    while (player.Step()) {
+    }
+  } else {
+    Renderer renderer(kScreenWidth, kScreenHeight, replay.grid_width,
+                      replay.grid_height);
+    FrameSnapshot frame(replay.grid_width * replay.grid_height,
+                        replay.ai_snakes, Game::kFixedObstacles,
+                        replay.hazards);
+    InputQueue commands;
+    std::string no_name;
+    bool running = true;
+    bool paused = false;
+    bool show_profiler = false;  // No profiler during playback
+    while (running) {
+      controller.HandleInput(running, false, no_name, commands, show_profiler);
+      InputCommand command;
+      while (commands.Pop(command)) {
+        const std::size_t tick = player.State().GetTicks();
+        if (command == InputCommand::kLeft) {
+          player.Seek(tick > kJumpTicks ? tick - kJumpTicks : 0);
+        } else if (command == InputCommand::kRight) {
+          player.Seek(tick + kJumpTicks);
+        } else if (command == InputCommand::kTogglePause) {
+          paused = !paused;
+        }
+      }
+      const bool stepped = !paused && player.Step();
+      player.State().Snapshot(frame);
+      renderer.Render(frame.View(1.0f, no_name));
+      renderer.Present();
+      if (!stepped) {
+        // Nothing moves until a key is pressed.
+        SDL_WaitEventTimeout(nullptr, 100);
+      }
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  Game const &game = player.State();
+  std::cout << "Ticks: " << game.GetTicks() << " of " << replay.end_tick
+            << "\n";
+  if (!render) {
+    std::cout << "Ticks/s: "
+              << (elapsed.count() > 0.0 ? game.GetTicks() / elapsed.count()
+                                        : 0.0)
+              << "\n";
+  }
+  std::cout << "Score: " << game.GetScore() << "\n";
+  std::cout << "AI Score: " << game.GetAIScore() << "\n";
+  std::cout << "Size: " << game.GetSize() << "\n";
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  constexpr std::size_t kTicksPerSecond{60};    // Simulation rate
+  constexpr std::size_t kFramesPerSecond{144};  // Display frame cap
+
+  bool headless = false;
+  std::size_t max_ticks = 100000;
+  std::string script_path;
+  std::size_t ai_snakes = 1;
+  std::size_t hazards = 3;  // Moving obstacles
+  Game::AIPolicy policy = Game::AIPolicy::kSearch;
+  std::size_t think_us = 0;
+  std::size_t grid_width = 32;
+  std::size_t grid_height = 32;
+  std::uint32_t seed = std::random_device{}();
+  std::string record_path;
+  std::string trace_path;
+  std::string replay_path;
+  std::size_t seek_tick = 0;
+  bool render = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--headless") == 0) {
+      headless = true;
+    } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+      max_ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+      script_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--ai") == 0 && i + 1 < argc) {
+      ai_snakes = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--hazards") == 0 && i + 1 < argc) {
+      hazards = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--policy") == 0 && i + 1 < argc &&
+               Game::ParsePolicy(argv[i + 1], policy)) {
+      ++i;
+    } else if (std::strcmp(argv[i], "--think-us") == 0 && i + 1 < argc) {
+      think_us = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--grid") == 0 && i + 2 < argc) {
+      grid_width = std::strtoull(argv[++i], nullptr, 10);
+      grid_height = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      record_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      trace_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      replay_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--seek") == 0 && i + 1 < argc) {
+      seek_tick = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--render") == 0) {
+      render = true;
+    } else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (grid_width < 4 || grid_height < 4 || grid_width > kFixedMaxCells ||
+      grid_height > kFixedMaxCells) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  if (!replay_path.empty()) {
+    return PlayReplay(replay_path, seek_tick, render);
+  }
 
-  Renderer renderer(kScreenWidth, kScreenHeight, kGridWidth, kGridHeight);
   Controller controller;
-  Game game(kGridWidth, kGridHeight);
-  game.Run(controller, renderer, kMsPerFrame);
-  std::cout << "Game has terminated successfully!\n";
+  Game game(grid_width, grid_height, seed, ai_snakes, hazards, policy);
+  game.SetThinkBudget(std::chrono::microseconds(think_us));
+  Replay recording;
+  if (!record_path.empty()) {
+    recording.seed = seed;
+    recording.grid_width = grid_width;
+    recording.grid_height = grid_height;
+    recording.ai_snakes = ai_snakes;
+    recording.hazards = hazards;
+    recording.policy = policy;
+    game.RecordTo(&recording);
+  }
+  // With several AI snakes, their path planning is spread over every core.
+  std::unique_ptr<ThreadPool> planning_pool;
+  if (ai_snakes > 1) {
+    planning_pool = std::make_unique<ThreadPool>();
+    game.SetPlanningPool(planning_pool.get());
+  }
+
+  if (headless) {
+    InputScript script;
+    if (!script_path.empty() && !script.Load(script_path)) {
+      return 1;
+    }
+    double seconds = game.RunHeadless(controller, max_ticks,
+                                      script_path.empty() ? nullptr : &script);
+    std::cout << "Ticks: " << game.GetTicks() << "\n";
+    std::cout << "Ticks/s: "
+              << (seconds > 0.0 ? game.GetTicks() / seconds : 0.0) << "\n";
+  } else {
+    Renderer renderer(kScreenWidth, kScreenHeight, grid_width, grid_height);
+    // Always on for the F3 overlay; spans are only kept for --trace.
+    FrameProfiler profiler(!trace_path.empty());
+    game.SetProfiler(&profiler);
+    game.LoadHighScores();
+    game.Run(controller, renderer, kTicksPerSecond, kFramesPerSecond);
+    game.SetProfiler(nullptr);
+    std::cout << "Game has terminated successfully!\n";
+    if (!trace_path.empty() && !profiler.WriteTrace(trace_path)) {
+      return 1;
+    }
+  }
+  if (!record_path.empty()) {
+    recording.end_tick = game.GetTicks();
+    if (!recording.Save(record_path)) {
+      return 1;
+    }
+  }
   std::cout << "Score: " << game.GetScore() << "\n";
+  std::cout << "AI Score: " << game.GetAIScore() << "\n";
   std::cout << "Size: " << game.GetSize() << "\n";
   return 0;
-}
\ No newline at end of file
+}
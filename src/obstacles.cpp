@@ -0,0 +1,74 @@
+#include "obstacles.h"
+#include <algorithm>
+
+MovingObstacles::MovingObstacles(std::size_t grid_width,
+                                 std::size_t grid_height)
+    : width(FixedFromInt(static_cast<int>(grid_width))),
+      height(FixedFromInt(static_cast<int>(grid_height))),
+      grid_width(static_cast<int>(grid_width)),
+      count(grid_width * grid_height, 0) {}
+
+void MovingObstacles::Reserve(std::size_t capacity) {
+  for (auto *array : {&x, &y, &dx, &dy, &prev_x, &prev_y}) {
+    array->reserve(capacity);
+  }
+  cell.reserve(capacity);
+}
+
+void MovingObstacles::Add(int cell_x, int cell_y, Snake::Direction dir,
+                          Fixed speed, OccupancyGrid &occupancy) {
+  x.push_back(FixedFromInt(cell_x));
+  y.push_back(FixedFromInt(cell_y));
+  prev_x.push_back(x.back());
+  prev_y.push_back(y.back());
+  dx.push_back(dir == Snake::Direction::kRight  ? speed
+               : dir == Snake::Direction::kLeft ? -speed
+                                                : 0);
+  dy.push_back(dir == Snake::Direction::kDown ? speed
+               : dir == Snake::Direction::kUp ? -speed
+                                              : 0);
+  cell.push_back(cell_y * grid_width + cell_x);
+  if (count[cell.back()]++ == 0) {
+    occupancy.Set(cell_x, cell_y, OccupancyGrid::kMovingObstacle);
+  }
+}
+
+void MovingObstacles::Step(OccupancyGrid &occupancy) {
+  const std::size_t n = x.size();
+  std::copy(x.begin(), x.end(), prev_x.begin());
+  std::copy(y.begin(), y.end(), prev_y.begin());
+
+  // Speeds are below one cell per tick, so a single compare and subtract
+  // brings any position back onto the board.
+  Fixed *px = x.data();
+  Fixed *py = y.data();
+  const Fixed *pdx = dx.data();
+  const Fixed *pdy = dy.data();
+  for (std::size_t i = 0; i < n; ++i) {
+    Fixed nx = px[i] + pdx[i];
+    Fixed ny = py[i] + pdy[i];
+    nx = nx < 0 ? nx + width : nx;
+    nx = nx >= width ? nx - width : nx;
+    ny = ny < 0 ? ny + height : ny;
+    ny = ny >= height ? ny - height : ny;
+    px[i] = nx;
+    py[i] = ny;
+  }
+
+  // Obstacles cross into a new cell only every few ticks; the rest leave the
+  // grid alone.
+  for (std::size_t i = 0; i < n; ++i) {
+    const int cx = FixedCell(px[i]);
+    const int cy = FixedCell(py[i]);
+    const int now = cy * grid_width + cx;
+    if (now == cell[i]) continue;
+    if (--count[cell[i]] == 0) {
+      occupancy.Clear(cell[i] % grid_width, cell[i] / grid_width,
+                      OccupancyGrid::kMovingObstacle);
+    }
+    if (count[now]++ == 0) {
+      occupancy.Set(cx, cy, OccupancyGrid::kMovingObstacle);
+    }
+    cell[i] = now;
+  }
+}
@@ -0,0 +1,57 @@
+#ifndef OBSTACLES_H
+#define OBSTACLES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "fixed_point.h"
+#include "occupancy_grid.h"
+#include "snake.h"
+
+// Moving obstacles, stored as parallel arrays so a step is a flat loop over
+// 16.16 fixed-point integers the compiler can vectorise. Headings are kept as
+// velocities and the edges are wrapped with a compare and add or subtract,
+// so the loop has no branches and no division. A per-cell count of
+// obstacles keeps the kMovingObstacle marks in the occupancy grid right when
+// several share a cell, and only obstacles that actually changed cell touch
+// the grid.
+class MovingObstacles {
+ public:
+  MovingObstacles(std::size_t grid_width, std::size_t grid_height);
+
+  // Adds an obstacle on cell (x, y) heading `dir` at `speed` cells per tick,
+  // and marks the cell in `occupancy`.
+  void Add(int x, int y, Snake::Direction dir, Fixed speed,
+           OccupancyGrid &occupancy);
+  void Reserve(std::size_t capacity);
+
+  // Advances every obstacle by one tick and updates `occupancy`.
+  void Step(OccupancyGrid &occupancy);
+
+  std::size_t Size() const { return x.size(); }
+  // Positions after and before the last Step(), for drawing.
+  const std::vector<Fixed> &X() const { return x; }
+  const std::vector<Fixed> &Y() const { return y; }
+  const std::vector<Fixed> &PrevX() const { return prev_x; }
+  const std::vector<Fixed> &PrevY() const { return prev_y; }
+  // Velocities, in cells per tick.
+  const std::vector<Fixed> &DX() const { return dx; }
+  const std::vector<Fixed> &DY() const { return dy; }
+
+ private:
+  Fixed width;
+  Fixed height;
+  int grid_width;
+
+  std::vector<Fixed> x;
+  std::vector<Fixed> y;
+  std::vector<Fixed> dx;
+  std::vector<Fixed> dy;
+  std::vector<Fixed> prev_x;
+  std::vector<Fixed> prev_y;
+  std::vector<int> cell;  // Grid index of the cell each obstacle is on
+
+  std::vector<std::uint16_t> count;  // Obstacles per grid cell
+};
+
+#endif
@@ -0,0 +1,14 @@
+#include "occupancy_grid.h"
+
+OccupancyGrid::OccupancyGrid(std::size_t width, std::size_t height)
+    : width(static_cast<int>(width)),
+      height(static_cast<int>(height)),
+      cells(width * height, 0),
+      free_cells(width * height),
+      free_slot(width * height),
+      ai_bodies(width * height, 0),
+      occupied_bits(width, height) {
+  for (std::size_t i = 0; i < free_cells.size(); ++i) {
+    free_cells[i] = free_slot[i] = static_cast<int>(i);
+  }
+}
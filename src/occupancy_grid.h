@@ -0,0 +1,100 @@
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bitboard.h"
+
+// Flat per-cell occupancy map owned by Game. Each cell holds a bitfield of
+// whatever currently covers it, so collision and pathfinding queries are a
+// single byte lookup instead of a scan over snake bodies and obstacle lists.
+// The cells nothing covers are also kept as a set (a dense array plus each
+// cell's slot in it, removed by swapping with the last entry), so picking a
+// random free cell is one draw however full the board is. Occupied cells are
+// mirrored in a Bitboard for word-parallel flood fills.
+//
+// All AI snakes share kAIBody, and a dead snake's body stays on the board,
+// so one cell can hold parts of several AI bodies: a snake that dies by
+// running into another leaves its head on the other's body. A per-cell count
+// of AI body parts keeps the flag set until the last of them has gone.
+class OccupancyGrid {
+ public:
+  enum Flag : std::uint8_t {
+    kPlayerBody = 1 << 0,
+    kAIBody = 1 << 1,
+    kFixedObstacle = 1 << 2,
+    kMovingObstacle = 1 << 3,
+  };
+  static constexpr std::uint8_t kSnake = kPlayerBody | kAIBody;
+  static constexpr std::uint8_t kObstacle = kFixedObstacle | kMovingObstacle;
+
+  OccupancyGrid(std::size_t width, std::size_t height);
+
+  void Set(int x, int y, std::uint8_t flags) {
+    const int i = Index(x, y);
+    if ((flags & kAIBody) != 0) ++ai_bodies[i];
+    if (cells[i] == 0 && flags != 0) {
+      ++version;
+      RemoveFree(i);
+      occupied_bits.Set(x, y);
+    }
+    cells[i] |= flags;
+  }
+  void Clear(int x, int y, std::uint8_t flags) {
+    const int i = Index(x, y);
+    if (cells[i] == 0) return;
+    if ((flags & kAIBody) != 0 && ai_bodies[i] > 0 && --ai_bodies[i] > 0) {
+      flags &= static_cast<std::uint8_t>(~kAIBody);
+    }
+    cells[i] &= static_cast<std::uint8_t>(~flags);
+    if (cells[i] == 0) {
+      ++version;
+      AddFree(i);
+      occupied_bits.Reset(x, y);
+    }
+  }
+  bool Test(int x, int y, std::uint8_t flags) const {
+    return (cells[Index(x, y)] & flags) != 0;
+  }
+  bool Occupied(int x, int y) const { return cells[Index(x, y)] != 0; }
+  bool Occupied(int cell) const { return cells[cell] != 0; }
+
+  int Width() const { return width; }
+  int Height() const { return height; }
+  int Index(int x, int y) const { return y * width + x; }
+
+  // Bumped whenever a cell goes from free to occupied or back, so anything
+  // derived from the grid can tell whether it might be out of date.
+  std::uint64_t Version() const { return version; }
+
+  // Unoccupied cells, as indices in no particular order.
+  std::size_t FreeCount() const { return free_cells.size(); }
+  int FreeCell(std::size_t n) const { return free_cells[n]; }
+
+  // Every occupied cell as one bit, whatever covers it.
+  const Bitboard &OccupiedBits() const { return occupied_bits; }
+
+ private:
+  void AddFree(int i) {
+    free_slot[i] = static_cast<int>(free_cells.size());
+    free_cells.push_back(i);
+  }
+  void RemoveFree(int i) {
+    const int last = free_cells.back();
+    free_cells[free_slot[i]] = last;
+    free_slot[last] = free_slot[i];
+    free_cells.pop_back();
+  }
+
+  int width;
+  int height;
+  std::vector<std::uint8_t> cells;
+  std::vector<int> free_cells;
+  std::vector<int> free_slot;  // Position of each free cell in free_cells
+  std::vector<std::uint16_t> ai_bodies;  // AI body parts on each cell
+  Bitboard occupied_bits;
+  std::uint64_t version{0};
+};
+
+#endif
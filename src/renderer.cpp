@@ -3,7 +3,23 @@
 #include <string>
 #include "SDL.h"
 #include "SDL_ttf.h"
-#include "game.h"  // Added: For MovingObstacle struct access
+
+namespace {
+
+// Blends a coordinate between two simulation steps on a wrapping axis of
+// length `extent`, taking the short way round when the step crossed an edge.
+int Interpolate(float prev, float current, float alpha, std::size_t extent) {
+  const float size = static_cast<float>(extent);
+  float delta = current - prev;
+  if (delta > size / 2) delta -= size;
+  if (delta < -size / 2) delta += size;
+  float value = prev + delta * alpha;
+  if (value < 0) value += size;
+  if (value >= size) value -= size;
+  return static_cast<int>(value);
+}
+
+}  // namespace
 
 Renderer::Renderer(const std::size_t screen_width,
                    const std::size_t screen_height,
@@ -12,6 +28,9 @@ Renderer::Renderer(const std::size_t screen_width,
       screen_height(screen_height),
       grid_width(grid_width),
       grid_height(grid_height) {
+  // Enough for every cell on the board, so batching never reallocates.
+  cell_batch.reserve(grid_width * grid_height);
+
   // Initialize SDL
   if (SDL_Init(SDL_INIT_VIDEO) < 0) {
     std::cerr << "SDL could not initialize.\n";
@@ -47,157 +66,231 @@ Renderer::Renderer(const std::size_t screen_width,
     std::cerr << "Renderer could not be created.\n";
     std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
   }
+
+  // Rasterise the font's glyphs once, instead of the text every frame.
+  if (font != nullptr && sdl_renderer != nullptr) {
+    glyph_atlas = std::make_unique<GlyphAtlas>(sdl_renderer, font);
+  }
 }
 
 Renderer::~Renderer() {
+  glyph_atlas.reset();  // Its texture belongs to sdl_renderer
+  if (static_layer != nullptr) {
+    SDL_DestroyTexture(static_layer);
+  }
   TTF_CloseFont(font);  // Added: Clean up font
   TTF_Quit();  // Added: Quit SDL_ttf
   SDL_DestroyWindow(sdl_window);
   SDL_Quit();
 }
 
-void Renderer::Render(Snake const snake, Snake const &ai_snake, SDL_Point const &food, bool paused, bool game_over,
-                      int score, int ai_score, const std::string &name_input, int global_high_score,
-                      const std::string &global_high_name,
-                      const std::vector<SDL_Point> &fixed_obstacles,
-                      const std::vector<MovingObstacle> &moving_obstacles) {
+void Renderer::Render(FrameView const &frame) {
   SDL_Rect block;
   block.w = screen_width / grid_width;
   block.h = screen_height / grid_height;
 
-  // Clear screen
-  SDL_SetRenderDrawColor(sdl_renderer, 0x1E, 0x1E, 0x1E, 0xFF);
-  SDL_RenderClear(sdl_renderer);
-
-  // Modified: Render game elements (food, snake, obstacles) always, to show final state on game over
-
-  // Render food (green)
-  SDL_SetRenderDrawColor(sdl_renderer, 0x00, 0xFF, 0x00, 0xFF);
-  block.x = food.x * block.w;
-  block.y = food.y * block.h;
-  SDL_RenderFillRect(sdl_renderer, &block);
-
-  // Render player's snake body
-  SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-  for (SDL_Point const &point : snake.body) {
-    block.x = point.x * block.w;
-    block.y = point.y * block.h;
-    SDL_RenderFillRect(sdl_renderer, &block);
+  // Background and fixed obstacles (red)
+  if (!static_layer_tried) {
+    BuildStaticLayer(frame.fixed_obstacles, block);
   }
-
-  // Render player's snake head
-  block.x = static_cast<int>(snake.head_x) * block.w;
-  block.y = static_cast<int>(snake.head_y) * block.h;
-  if (snake.alive) {
-    SDL_SetRenderDrawColor(sdl_renderer, 0x00, 0x7A, 0xCC, 0xFF);
+  if (static_layer != nullptr) {
+    SDL_RenderCopy(sdl_renderer, static_layer, nullptr, nullptr);
   } else {
-    SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0x00, 0x00, 0xFF);
-  }
-  SDL_RenderFillRect(sdl_renderer, &block);
-
-  // Added: Render AI snake's body (gray)
-  SDL_SetRenderDrawColor(sdl_renderer, 0xAA, 0xAA, 0xAA, 0xFF);
-  for (SDL_Point const &point : ai_snake.body) {
-    block.x = point.x * block.w;
-    block.y = point.y * block.h;
-    SDL_RenderFillRect(sdl_renderer, &block);
+    DrawStaticLayer(frame.fixed_obstacles, block);
   }
 
-  // Added: Render AI snake's head (green if alive)
-  block.x = static_cast<int>(ai_snake.head_x) * block.w;
-  block.y = static_cast<int>(ai_snake.head_y) * block.h;
-  if (ai_snake.alive) {
-    SDL_SetRenderDrawColor(sdl_renderer, 0x00, 0xCC, 0x7A, 0xFF);
-  } else {
-    SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0x00, 0x00, 0xFF);
-  }
-  SDL_RenderFillRect(sdl_renderer, &block);
+  // Modified: Render game elements (food, snake, obstacles) always, to show final state on game over
 
-  // Added: Render fixed obstacles (red)
-  SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0x00, 0x00, 0xFF);
-  for (const auto& ob : fixed_obstacles) {
-    block.x = ob.x * block.w;
-    block.y = ob.y * block.h;
+  // Render food (green); it is off the board while the board is full
+  if (frame.food.x >= 0) {
+    SDL_SetRenderDrawColor(sdl_renderer, 0x00, 0xFF, 0x00, 0xFF);
+    block.x = frame.food.x * block.w;
+    block.y = frame.food.y * block.h;
     SDL_RenderFillRect(sdl_renderer, &block);
   }
 
+  // Render player's snake (white body, blue head), then the AI snakes (gray
+  // body, green head)
+  RenderSnakes({&frame.player, 1}, {0xFF, 0xFF, 0xFF, 0xFF},
+               {0x00, 0x7A, 0xCC, 0xFF}, frame.alpha, block);
+  RenderSnakes(frame.ai, {0xAA, 0xAA, 0xAA, 0xFF}, {0x00, 0xCC, 0x7A, 0xFF},
+               frame.alpha, block);
+
   // Added: Render moving obstacles (yellow)
-  SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0xCC, 0x00, 0xFF); 
-  for (const auto& mo : moving_obstacles) {
-    block.x = static_cast<int>(mo.x) * block.w;
-    block.y = static_cast<int>(mo.y) * block.h;
-    SDL_RenderFillRect(sdl_renderer, &block);
+  BeginBatch();
+  const MovingObstaclesView &obstacles = frame.moving_obstacles;
+  for (std::size_t i = 0; i < obstacles.x.size; ++i) {
+    AddCell(Interpolate(obstacles.prev_x.data[i], obstacles.x.data[i],
+                        frame.alpha, grid_width),
+            Interpolate(obstacles.prev_y.data[i], obstacles.y.data[i],
+                        frame.alpha, grid_height),
+            block);
   }
+  SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0xCC, 0x00, 0xFF);
+  FlushBatch();
+
+  SDL_Color textColor = {255, 255, 255, 255};
 
   // Render paused text if applicable
-  if (paused && font != nullptr) {
-    SDL_Color textColor = {255, 255, 255, 255};
+  if (frame.paused) {
     RenderText("PAUSED", screen_width / 2, screen_height / 2, textColor, true);
   }
 
   // Added: Render AI score in top-right
-  SDL_Color textColor = {255, 255, 255, 255};
-  std::string ai_score_text = "AI: " + std::to_string(ai_score);
-  RenderText(ai_score_text, screen_width - 10, 10, textColor, false);
+  hud_text.assign("AI: ").append(std::to_string(frame.ai_score));
+  RenderText(hud_text, screen_width - 10, 10, textColor, false);
 
-  if (game_over) {
+  if (frame.game_over) {
     // Render Game Over texts (overlaid on the game state)
     RenderText("Game Over", screen_width / 2, screen_height / 4, textColor, true);
 
-    std::string score_text = "Score: " + std::to_string(score);
-    RenderText(score_text, screen_width / 2, screen_height / 3, textColor, true);
+    hud_text.assign("Score: ").append(std::to_string(frame.score));
+    RenderText(hud_text, screen_width / 2, screen_height / 3, textColor, true);
 
-    std::string high_text = "High Score: " + global_high_name + " - " + std::to_string(global_high_score);
-    RenderText(high_text, screen_width / 2, screen_height / 2.5, textColor, true);
+    hud_text.assign("High Score: ")
+        .append(frame.global_high_name)
+        .append(" - ")
+        .append(std::to_string(frame.global_high_score));
+    RenderText(hud_text, screen_width / 2, screen_height / 2.5, textColor, true);
 
-    if (score > global_high_score) {
+    if (frame.score > frame.global_high_score) {
       RenderText("New High Score!", screen_width / 2, screen_height / 2, textColor, true);
     }
 
     RenderText("Enter your name:", screen_width / 2, screen_height / 1.5, textColor, true);
 
     // Add blinking cursor
-    std::string display_name = name_input;
+    hud_text.assign(frame.name_input);
     if ((SDL_GetTicks() / 500) % 2 == 0) {
-      display_name += "_";
+      hud_text += '_';
     }
-    RenderText(display_name, screen_width / 2, screen_height / 1.4, textColor, true);
+    RenderText(hud_text, screen_width / 2, screen_height / 1.4, textColor, true);
 
     // Added: Show AI score on game over
-    std::string ai_final_text = "AI Score: " + std::to_string(ai_score);
-    RenderText(ai_final_text, screen_width / 2, screen_height / 2.2, textColor, true);
+    hud_text.assign("AI Score: ").append(std::to_string(frame.ai_score));
+    RenderText(hud_text, screen_width / 2, screen_height / 2.2, textColor, true);
+  }
+
+  if (frame.overlay.size > 0) {
+    RenderOverlay(frame.overlay);
+  }
+
+  if (glyph_atlas != nullptr) {
+    glyph_atlas->Flush();
   }
+}
 
-  // Update Screen
-  SDL_RenderPresent(sdl_renderer);
+void Renderer::Present() { SDL_RenderPresent(sdl_renderer); }
+
+// Small text on a translucent panel in the top-left corner.
+void Renderer::RenderOverlay(Span<std::string> lines) {
+  constexpr float kScale = 0.3f;
+  constexpr int kMargin = 6;
+  const int line_height =
+      font != nullptr ? static_cast<int>(TTF_FontLineSkip(font) * kScale) : 15;
+
+  SDL_Rect panel{0, 0, static_cast<int>(screen_width * 3 / 4),
+                 static_cast<int>(lines.size) * line_height + 2 * kMargin};
+  SDL_SetRenderDrawBlendMode(sdl_renderer, SDL_BLENDMODE_BLEND);
+  SDL_SetRenderDrawColor(sdl_renderer, 0x00, 0x00, 0x00, 0xB0);
+  SDL_RenderFillRect(sdl_renderer, &panel);
+  SDL_SetRenderDrawBlendMode(sdl_renderer, SDL_BLENDMODE_NONE);
+
+  if (glyph_atlas == nullptr) return;
+  int y = kMargin;
+  for (const std::string &line : lines) {
+    glyph_atlas->Queue(line, kMargin, y, {0xFF, 0xFF, 0x80, 0xFF}, false,
+                       kScale);
+    y += line_height;
+  }
 }
 
-void Renderer::UpdateWindowTitle(int score, int fps) {
-  std::string title{"Snake Score: " + std::to_string(score) + " FPS: " + std::to_string(fps)};
-  SDL_SetWindowTitle(sdl_window, title.c_str());
+void Renderer::RenderSnakes(Span<SnakeView> snakes, SDL_Color body,
+                            SDL_Color head, float alpha, SDL_Rect block) {
+  // Cells sharing a color are gathered into one batch and submitted with a
+  // single SDL_RenderFillRects call, so draw calls grow with neither length
+  // nor the number of snakes.
+  BeginBatch();
+  for (SnakeView const &snake : snakes) {
+    for (const auto &run : snake.body) {
+      for (SDL_Point const &point : run) {
+        AddCell(point.x, point.y, block);
+      }
+    }
+  }
+  SDL_SetRenderDrawColor(sdl_renderer, body.r, body.g, body.b, body.a);
+  FlushBatch();
+
+  // Heads, live ones interpolated. A dead snake no longer steps, so its head
+  // is drawn in red where it ended up.
+  for (bool alive : {true, false}) {
+    BeginBatch();
+    for (SnakeView const &snake : snakes) {
+      if (snake.alive != alive) continue;
+      const float a = alive ? alpha : 1.0f;
+      AddCell(Interpolate(snake.prev_head_x, snake.head_x, a, grid_width),
+              Interpolate(snake.prev_head_y, snake.head_y, a, grid_height),
+              block);
+    }
+    const SDL_Color color = alive ? head : SDL_Color{0xFF, 0x00, 0x00, 0xFF};
+    SDL_SetRenderDrawColor(sdl_renderer, color.r, color.g, color.b, color.a);
+    FlushBatch();
+  }
 }
 
-// Added: Helper function
-void Renderer::RenderText(const std::string &text, int x, int y, SDL_Color color, bool center) {
-  if (text.empty() || font == nullptr) return;
+void Renderer::BuildStaticLayer(Span<SDL_Point> fixed_obstacles,
+                                SDL_Rect const &block) {
+  static_layer_tried = true;
+  if (!SDL_RenderTargetSupported(sdl_renderer)) return;
 
-  SDL_Surface* textSurface = TTF_RenderText_Solid(font, text.c_str(), color);
-  if (textSurface == nullptr) return;
+  static_layer = SDL_CreateTexture(sdl_renderer, SDL_PIXELFORMAT_RGBA8888,
+                                   SDL_TEXTUREACCESS_TARGET, screen_width,
+                                   screen_height);
+  if (static_layer == nullptr) return;
 
-  SDL_Texture* textTexture = SDL_CreateTextureFromSurface(sdl_renderer, textSurface);
-  if (textTexture == nullptr) {
-    SDL_FreeSurface(textSurface);
+  if (SDL_SetRenderTarget(sdl_renderer, static_layer) != 0) {
+    SDL_DestroyTexture(static_layer);
+    static_layer = nullptr;
     return;
   }
+  DrawStaticLayer(fixed_obstacles, block);
+  SDL_SetRenderTarget(sdl_renderer, nullptr);
+}
+
+void Renderer::DrawStaticLayer(Span<SDL_Point> fixed_obstacles,
+                               SDL_Rect const &block) {
+  // Clear screen
+  SDL_SetRenderDrawColor(sdl_renderer, 0x1E, 0x1E, 0x1E, 0xFF);
+  SDL_RenderClear(sdl_renderer);
 
-  int textWidth = textSurface->w;
-  int textHeight = textSurface->h;
-  SDL_Rect textRect = {x, y, textWidth, textHeight};
-  if (center) {
-    textRect.x -= textWidth / 2;
+  // Added: Render fixed obstacles (red)
+  BeginBatch();
+  for (const auto& ob : fixed_obstacles) {
+    AddCell(ob.x, ob.y, block);
   }
+  SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0x00, 0x00, 0xFF);
+  FlushBatch();
+}
+
+void Renderer::BeginBatch() { cell_batch.clear(); }
+
+void Renderer::AddCell(int x, int y, SDL_Rect const &block) {
+  cell_batch.push_back({x * block.w, y * block.h, block.w, block.h});
+}
+
+void Renderer::FlushBatch() {
+  if (cell_batch.empty()) return;
+  SDL_RenderFillRects(sdl_renderer, cell_batch.data(),
+                      static_cast<int>(cell_batch.size()));
+}
+
+void Renderer::UpdateWindowTitle(int score, int fps) {
+  std::string title{"Snake Score: " + std::to_string(score) + " FPS: " + std::to_string(fps)};
+  SDL_SetWindowTitle(sdl_window, title.c_str());
+}
 
-  SDL_RenderCopy(sdl_renderer, textTexture, nullptr, &textRect);
-  SDL_DestroyTexture(textTexture);
-  SDL_FreeSurface(textSurface);
-}
\ No newline at end of file
+// Added: Helper function
+void Renderer::RenderText(std::string_view text, int x, int y, SDL_Color color, bool center) {
+  if (glyph_atlas == nullptr) return;
+  glyph_atlas->Queue(text, x, y, color, center);
+}
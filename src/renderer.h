@@ -1,13 +1,14 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <memory>
 #include <vector>
 #include <string>  // Added
+#include <string_view>
 #include "SDL.h"
 #include "SDL_ttf.h"
-#include "snake.h"
-
-struct MovingObstacle;
+#include "frame_view.h"
+#include "glyph_atlas.h"
 
 class Renderer {
  public:
@@ -15,26 +16,49 @@ class Renderer {
            const std::size_t grid_width, const std::size_t grid_height);
   ~Renderer();
 
-  // Modified: Added AI snake and ai_score params
-  void Render(Snake const snake, Snake const &ai_snake, SDL_Point const &food, bool paused, bool game_over,
-              int score, int ai_score, const std::string &name_input, int global_high_score,
-              const std::string &global_high_name,
-              const std::vector<SDL_Point> &fixed_obstacles,
-              const std::vector<MovingObstacle> &moving_obstacles);
+  // Draws one frame into the back buffer. Reads the view in place; nothing in
+  // it is copied and the render path doesn't allocate once warmed up.
+  void Render(FrameView const &frame);
+  // Shows the frame drawn by Render().
+  void Present();
   void UpdateWindowTitle(int score, int fps);
 
  private:
   SDL_Window *sdl_window;
   SDL_Renderer *sdl_renderer;
   TTF_Font *font;
+  std::unique_ptr<GlyphAtlas> glyph_atlas;  // Built from `font` at startup
 
   const std::size_t screen_width;
   const std::size_t screen_height;
   const std::size_t grid_width;
   const std::size_t grid_height;
 
-  // Added: Helper for text rendering
-  void RenderText(const std::string &text, int x, int y, SDL_Color color, bool center);
+  // Background and fixed obstacles never change once a game has started, so
+  // they are drawn once into a render-target texture and copied in as the
+  // bottom layer of every frame. If render targets aren't available the
+  // layer is drawn directly each frame instead.
+  SDL_Texture *static_layer{nullptr};
+  bool static_layer_tried{false};
+  void BuildStaticLayer(Span<SDL_Point> fixed_obstacles, SDL_Rect const &block);
+  void DrawStaticLayer(Span<SDL_Point> fixed_obstacles, SDL_Rect const &block);
+
+  // Reusable rect batch, filled with one color's cells and submitted in a
+  // single draw call.
+  std::vector<SDL_Rect> cell_batch;
+  void BeginBatch();
+  void AddCell(int x, int y, SDL_Rect const &block);
+  void FlushBatch();  // Draws the batch in the current draw color
+  void RenderSnakes(Span<SnakeView> snakes, SDL_Color body, SDL_Color head,
+                    float alpha, SDL_Rect block);
+
+  // Scratch string for HUD lines; keeps its capacity between frames.
+  std::string hud_text;
+
+  // Added: Helper for text rendering. Text is queued on the glyph atlas and
+  // drawn in one batch just before the frame is presented.
+  void RenderText(std::string_view text, int x, int y, SDL_Color color, bool center);
+  void RenderOverlay(Span<std::string> lines);
 };
 
 #endif
\ No newline at end of file
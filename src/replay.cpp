@@ -0,0 +1,178 @@
+#include "replay.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "fixed_point.h"
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'N', 'K', 'R'};
+constexpr std::uint64_t kVersion = 3;
+// Largest board side a replay may name; well inside what fixed-point
+// positions can hold.
+constexpr std::uint64_t kMaxGridSide = 1 << 14;
+static_assert(kMaxGridSide <= kFixedMaxCells, "board sides must fit Fixed");
+
+void PutVarint(std::vector<char> &out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+// Reads one varint at `pos`, advancing it. False on truncated or overlong
+// input.
+bool GetVarint(const std::vector<char> &in, std::size_t &pos,
+               std::uint64_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (pos >= in.size()) return false;
+    const auto byte = static_cast<unsigned char>(in[pos++]);
+    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+bool Replay::Save(const std::string &path) const {
+  std::vector<char> out(std::begin(kMagic), std::end(kMagic));
+  for (std::uint64_t field : {kVersion, std::uint64_t{seed},
+                              std::uint64_t{grid_width},
+                              std::uint64_t{grid_height},
+                              std::uint64_t{ai_snakes}, std::uint64_t{hazards},
+                              static_cast<std::uint64_t>(policy),
+                              std::uint64_t{end_tick},
+                              std::uint64_t{events.size()}}) {
+    PutVarint(out, field);
+  }
+  std::size_t previous = 0;
+  for (const Event &event : events) {
+    PutVarint(out, (event.tick - previous) * 4 +
+                       static_cast<std::uint64_t>(event.command));
+    previous = event.tick;
+  }
+
+  std::ofstream file(path, std::ios::binary);
+  if (!file.write(out.data(), static_cast<std::streamsize>(out.size()))) {
+    std::cerr << "Could not write replay " << path << "\n";
+    return false;
+  }
+  return true;
+}
+
+bool Replay::Load(const std::string &path) {
+  events.clear();
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::cerr << "Could not open replay " << path << "\n";
+    return false;
+  }
+  const std::vector<char> in((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+
+  std::size_t pos = sizeof(kMagic);
+  std::uint64_t version = 0;
+  bool ok = in.size() >= pos &&
+            std::equal(std::begin(kMagic), std::end(kMagic), in.begin()) &&
+            GetVarint(in, pos, version);
+  // Games recorded before movement went fixed point can't be reproduced.
+  if (ok && version < kVersion) {
+    std::cerr << path << ": recorded by an older version of the game\n";
+    return false;
+  }
+  ok = ok && version == kVersion;
+  std::uint64_t fields[9] = {version};
+  for (int i = 1; ok && i < 9; ++i) {
+    ok = GetVarint(in, pos, fields[i]);
+  }
+  // Reject sizes no real recording has before building a game from them.
+  ok = ok && fields[2] >= 4 && fields[3] >= 4 &&
+       fields[2] <= kMaxGridSide && fields[3] <= kMaxGridSide &&
+       fields[4] + fields[5] <= fields[2] * fields[3] &&
+       fields[6] <= static_cast<std::uint64_t>(Game::AIPolicy::kMonteCarlo) &&
+       fields[8] <= in.size();
+
+  std::uint64_t tick = 0;
+  for (std::uint64_t i = 0; ok && i < fields[8]; ++i) {
+    std::uint64_t value;
+    ok = GetVarint(in, pos, value);
+    tick += value / 4;
+    events.push_back({tick, static_cast<InputCommand>(value % 4)});
+  }
+  if (!ok) {
+    std::cerr << path << ": not a valid replay\n";
+    events.clear();
+    return false;
+  }
+
+  seed = static_cast<std::uint32_t>(fields[1]);
+  grid_width = fields[2];
+  grid_height = fields[3];
+  ai_snakes = fields[4];
+  hazards = fields[5];
+  policy = static_cast<Game::AIPolicy>(fields[6]);
+  end_tick = fields[7];
+  return true;
+}
+
+ReplayPlayer::ReplayPlayer(Replay const &replay, Controller const &controller,
+                           std::size_t checkpoint_interval)
+    : replay(replay),
+      controller(controller),
+      checkpoint_interval(std::max<std::size_t>(checkpoint_interval, 1)),
+      game(replay.grid_width, replay.grid_height, replay.seed,
+           replay.ai_snakes, replay.hazards, replay.policy) {
+  checkpoints.push_back(game.Save());
+}
+
+void ReplayPlayer::SetPlanningPool(ThreadPool *pool) {
+  game.SetPlanningPool(pool);
+}
+
+bool ReplayPlayer::Done() const {
+  return game.IsOver() || game.GetTicks() >= replay.end_tick;
+}
+
+bool ReplayPlayer::Step() {
+  if (Done()) return false;
+
+  const std::size_t tick = game.GetTicks();
+  while (next_event < replay.events.size() &&
+         replay.events[next_event].tick <= tick) {
+    game.Apply(controller, replay.events[next_event].command);
+    ++next_event;
+  }
+  game.Update();
+
+  const std::size_t now = game.GetTicks();
+  if (now % checkpoint_interval == 0 &&
+      now / checkpoint_interval == checkpoints.size()) {
+    checkpoints.push_back(game.Save());
+  }
+  return true;
+}
+
+void ReplayPlayer::Seek(std::size_t tick) {
+  tick = std::min(tick, replay.end_tick);
+  // Resume from the last checkpoint at or before `tick`, unless the game is
+  // already between it and the target.
+  const std::size_t index =
+      std::min(tick / checkpoint_interval, checkpoints.size() - 1);
+  const std::size_t from = index * checkpoint_interval;
+  if (game.GetTicks() > tick || game.GetTicks() < from) {
+    game.Restore(checkpoints[index]);
+    next_event = static_cast<std::size_t>(
+        std::lower_bound(replay.events.begin(), replay.events.end(), from,
+                         [](const Replay::Event &event, std::size_t t) {
+                           return event.tick < t;
+                         }) -
+        replay.events.begin());
+  }
+  while (game.GetTicks() < tick && Step()) {
+  }
+}
@@ -0,0 +1,76 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "controller.h"
+#include "game.h"
+
+// A recorded game: the seed and settings it was started with and every
+// steering command that changed the player's direction, stamped with the
+// tick it was applied before. Games are deterministic given these, so
+// replaying the commands reproduces the game exactly.
+//
+// On disk it is a small binary file: the magic "SNKR", then unsigned LEB128
+// varints for the format version, seed, grid width and height, AI snake
+// count, moving obstacle count, AI policy, final tick and number of commands,
+// then one varint per command holding the ticks since the previous command
+// times four plus the direction. A typical command fits in a single byte.
+// Files from older versions of the format are refused: the game they were
+// recorded with moved snakes in floating point, which this one can't
+// reproduce.
+class Replay {
+ public:
+  struct Event {
+    std::size_t tick;
+    InputCommand command;  // kUp, kDown, kLeft or kRight
+  };
+
+  std::uint32_t seed{0};
+  std::size_t grid_width{32};
+  std::size_t grid_height{32};
+  std::size_t ai_snakes{1};
+  std::size_t hazards{3};
+  Game::AIPolicy policy{Game::AIPolicy::kSearch};
+  std::size_t end_tick{0};  // Ticks simulated when recording stopped
+  std::vector<Event> events;
+
+  // Returns false, with a message on stderr, if the file can't be written.
+  bool Save(const std::string &path) const;
+  // Returns false (leaving the replay empty) if the file can't be read or
+  // isn't a valid replay.
+  bool Load(const std::string &path);
+};
+
+// Plays a Replay back through Game::Update as fast as it can simulate. A
+// Game::Checkpoint is kept every `checkpoint_interval` ticks on the way, so
+// Seek() only has to resimulate from the closest one at or before the target.
+class ReplayPlayer {
+ public:
+  ReplayPlayer(Replay const &replay, Controller const &controller,
+               std::size_t checkpoint_interval = 600);
+
+  // Spreads the game's AI planning over `pool`; see Game::SetPlanningPool.
+  void SetPlanningPool(ThreadPool *pool);
+
+  // Simulates one tick. Returns false once the recording has ended.
+  bool Step();
+  // Moves to `tick` (clamped to the end of the recording).
+  void Seek(std::size_t tick);
+  bool Done() const;
+
+  Game const &State() const { return game; }
+
+ private:
+  Replay const &replay;
+  Controller const &controller;
+  std::size_t checkpoint_interval;
+  Game game;
+  std::size_t next_event{0};
+  // checkpoints[i] is at i * interval ticks
+  std::vector<Game::Checkpoint> checkpoints;
+};
+
+#endif
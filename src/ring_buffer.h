@@ -0,0 +1,129 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Fixed-capacity circular buffer with O(1) push at the back and pop at the
+// front. Storage is allocated once up front, so a buffer that never exceeds
+// its capacity never touches the allocator again.
+template <typename T>
+class RingBuffer {
+ public:
+  template <bool Const>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+    using reference = std::conditional_t<Const, const T &, T &>;
+    using Owner = std::conditional_t<Const, const RingBuffer, RingBuffer>;
+
+    Iterator(Owner *owner, std::size_t index) : owner(owner), index(index) {}
+
+    reference operator*() const { return (*owner)[index]; }
+    pointer operator->() const { return &(*owner)[index]; }
+    Iterator &operator++() {
+      ++index;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator old = *this;
+      ++index;
+      return old;
+    }
+    bool operator==(const Iterator &other) const { return index == other.index; }
+    bool operator!=(const Iterator &other) const { return index != other.index; }
+
+   private:
+    Owner *owner;
+    std::size_t index;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  explicit RingBuffer(std::size_t capacity) : storage(capacity) {}
+  // A copy of `other` with room for `capacity` elements, at least as many as
+  // it holds.
+  RingBuffer(const RingBuffer &other, std::size_t capacity)
+      : storage(capacity) {
+    Assign(other);
+  }
+
+  // Replaces the contents with a copy of `other`'s, keeping this buffer's
+  // capacity, which must be large enough.
+  void Assign(const RingBuffer &other) {
+    assert(other.count <= storage.size());
+    clear();
+    for (auto run : {other.FirstRun(), other.SecondRun()}) {
+      std::copy(run.first, run.first + run.second, storage.begin() + count);
+      count += run.second;
+    }
+  }
+
+  void push_back(const T &value) {
+    assert(count < storage.size());
+    storage[Physical(count)] = value;
+    ++count;
+  }
+  void pop_front() {
+    assert(count > 0);
+    start = Physical(1);
+    --count;
+  }
+  void clear() {
+    start = 0;
+    count = 0;
+  }
+
+  T &front() { return storage[start]; }
+  const T &front() const { return storage[start]; }
+  T &back() { return storage[Physical(count - 1)]; }
+  const T &back() const { return storage[Physical(count - 1)]; }
+
+  // Index 0 is the oldest element (the front).
+  T &operator[](std::size_t i) { return storage[Physical(i)]; }
+  const T &operator[](std::size_t i) const { return storage[Physical(i)]; }
+
+  std::size_t size() const { return count; }
+  std::size_t capacity() const { return storage.size(); }
+  bool empty() const { return count == 0; }
+
+  // The contents as two contiguous runs, front to back: the first from the
+  // front up to the end of storage, the second (often empty) from the start
+  // of storage. Lets callers walk the buffer without per-element wrapping.
+  std::pair<const T *, std::size_t> FirstRun() const {
+    const std::size_t n = std::min(count, storage.size() - start);
+    return {storage.data() + start, n};
+  }
+  std::pair<const T *, std::size_t> SecondRun() const {
+    const std::size_t n = count - FirstRun().second;
+    return {storage.data(), n};
+  }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, count); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, count); }
+
+ private:
+  // Maps a logical offset from the front to a slot in storage. Offsets never
+  // exceed the capacity, so a single conditional subtract replaces a modulo.
+  std::size_t Physical(std::size_t offset) const {
+    std::size_t i = start + offset;
+    return i >= storage.size() ? i - storage.size() : i;
+  }
+
+  std::vector<T> storage;
+  std::size_t start{0};
+  std::size_t count{0};
+};
+
+#endif
@@ -0,0 +1,200 @@
+#include "sim_state.h"
+#include <algorithm>
+#include "grid_geometry.h"
+
+namespace {
+
+constexpr Snake::Direction kDirections[] = {
+    Snake::Direction::kUp, Snake::Direction::kDown, Snake::Direction::kLeft,
+    Snake::Direction::kRight};
+
+// SplitMix64, to spread nearby seeds over the whole state.
+std::uint64_t Mix(std::uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+}  // namespace
+
+SimState::SimState(std::size_t grid_width, std::size_t grid_height)
+    : width(static_cast<int>(grid_width)),
+      height(static_cast<int>(grid_height)),
+      board(grid_width, grid_height),
+      snakes(),
+      obstacles() {}
+
+void SimState::Reset(const Bitboard &occupied, int food, std::uint64_t seed) {
+  board = occupied;
+  this->food = food;
+  snake_count = 0;
+  obstacle_count = 0;
+  Reseed(seed);
+}
+
+void SimState::Reseed(std::uint64_t seed) {
+  rng = Mix(seed) | 1;  // xorshift needs a non-zero state
+}
+
+bool SimState::AddSnake(Snake const &snake) {
+  if (snake_count == kMaxSnakes) return false;
+  SimSnake &s = snakes[snake_count++];
+  s.head = snake.HeadCell().y * width + snake.HeadCell().x;
+  s.alive = snake.alive;
+  s.growth = 0;
+  s.steps = 0;
+  s.eaten = 0;
+  s.trail_start = 0;
+  s.trail_count =
+      static_cast<int>(std::min<std::size_t>(snake.body.size(), kMaxSteps));
+  for (int i = 0; i < s.trail_count; ++i) {
+    const SDL_Point cell = snake.body[i];
+    s.trail[i] = cell.y * width + cell.x;
+  }
+  return true;
+}
+
+bool SimState::AddObstacle(Fixed x, Fixed y, Fixed dx, Fixed dy) {
+  if (obstacle_count == kMaxObstacles) return false;
+  obstacles[obstacle_count++] = {
+      x, y, dx, dy, FixedCell(y) * width + FixedCell(x), false};
+  return true;
+}
+
+template <typename Grid>
+void SimState::StepObstacle(Grid grid, SimObstacle &obstacle) {
+  const Fixed w = FixedFromInt(grid.Width());
+  const Fixed h = FixedFromInt(grid.Height());
+  obstacle.x += obstacle.dx;
+  obstacle.y += obstacle.dy;
+  if (obstacle.x < 0) obstacle.x += w;
+  if (obstacle.x >= w) obstacle.x -= w;
+  if (obstacle.y < 0) obstacle.y += h;
+  if (obstacle.y >= h) obstacle.y -= h;
+  const int cell = grid.Index(FixedCell(obstacle.x), FixedCell(obstacle.y));
+  if (cell == obstacle.cell) return;
+
+  // Whatever the obstacle passed over stays blocked behind it.
+  if (!obstacle.covering) {
+    board.Reset(grid.X(obstacle.cell), grid.Y(obstacle.cell));
+  }
+  obstacle.cell = cell;
+  obstacle.covering = Blocked(grid, cell);
+  board.Set(grid.X(cell), grid.Y(cell));
+  // Running onto a snake's head kills it, as in the game.
+  for (int i = 0; i < snake_count; ++i) {
+    if (snakes[i].alive && snakes[i].head == cell) snakes[i].alive = false;
+  }
+}
+
+template <typename Grid>
+int SimState::Neighbour(Grid grid, int cell, Snake::Direction dir) {
+  switch (dir) {
+    case Snake::Direction::kUp:
+      return grid.Up(cell);
+    case Snake::Direction::kDown:
+      return grid.Down(cell);
+    case Snake::Direction::kLeft:
+      return grid.Left(cell);
+    case Snake::Direction::kRight:
+      break;
+  }
+  return grid.Right(cell);
+}
+
+// xorshift64*, which is plenty for choosing among four moves.
+std::uint32_t SimState::NextRandom() {
+  rng ^= rng >> 12;
+  rng ^= rng << 25;
+  rng ^= rng >> 27;
+  return static_cast<std::uint32_t>((rng * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+template <typename Grid>
+void SimState::Move(Grid grid, SimSnake &snake, int target) {
+  // As in Snake::UpdateBody: the old head joins the body and the tail
+  // moves on, unless the snake is still growing.
+  constexpr int kCapacity = 2 * kMaxSteps;
+  if (snake.trail_count < kCapacity) {
+    snake.trail[(snake.trail_start + snake.trail_count) % kCapacity] =
+        snake.head;
+    ++snake.trail_count;
+  }
+  if (snake.growth > 0) {
+    --snake.growth;
+  } else if (snake.trail_count > 0) {
+    const int tail = snake.trail[snake.trail_start];
+    board.Reset(grid.X(tail), grid.Y(tail));
+    snake.trail_start = (snake.trail_start + 1) % kCapacity;
+    --snake.trail_count;
+  }
+
+  // A dead snake's body stays on the board, as in the game.
+  if (Blocked(grid, target)) {
+    snake.alive = false;
+    return;
+  }
+  board.Set(grid.X(target), grid.Y(target));
+  snake.head = target;
+  ++snake.steps;
+  if (target == food) {
+    ++snake.eaten;
+    ++snake.growth;
+    food = -1;
+  }
+}
+
+int SimState::Rollout(Snake::Direction first, int steps,
+                      const FlowField &field, int food_value) {
+  return DispatchGrid(width, height, [&](auto grid) {
+    return Play(grid, first, steps, field, food_value);
+  });
+}
+
+template <typename Grid>
+int SimState::Play(Grid grid, Snake::Direction first, int steps,
+                   const FlowField &field, int food_value) {
+  steps = std::min(steps, static_cast<int>(kMaxSteps));
+  for (int step = 0; step < steps && snakes[0].alive; ++step) {
+    for (int o = 0; o < obstacle_count; ++o) StepObstacle(grid, obstacles[o]);
+    if (!snakes[0].alive) break;
+    // The other snakes move first, so snake 0 sees where they went and a
+    // head-on meeting counts against it only when it walks into one.
+    for (int k = 1; k <= snake_count; ++k) {
+      const int i = k % snake_count;
+      SimSnake &snake = snakes[i];
+      if (!snake.alive) continue;
+      if (i == 0 && step == 0) {
+        Move(grid, snake, Neighbour(grid, snake.head, first));
+        continue;
+      }
+
+      int free[4];
+      int free_count = 0;
+      int closest = -1;
+      int closest_distance = FlowField::kUnreachable;
+      for (Snake::Direction dir : kDirections) {
+        const int cell = Neighbour(grid, snake.head, dir);
+        if (Blocked(grid, cell)) continue;
+        free[free_count++] = cell;
+        const int d = field.Distance(cell);
+        if (d < closest_distance) {
+          closest = cell;
+          closest_distance = d;
+        }
+      }
+      if (free_count == 0) {
+        Move(grid, snake, grid.Up(snake.head));  // Dies
+        continue;
+      }
+      const std::uint32_t r = NextRandom();
+      if (food >= 0 && closest >= 0 && (r & 3) != 0) {
+        Move(grid, snake, closest);
+      } else {
+        Move(grid, snake, free[(r >> 2) % free_count]);
+      }
+    }
+  }
+  return snakes[0].steps + food_value * snakes[0].eaten;
+}
@@ -0,0 +1,108 @@
+#ifndef SIM_STATE_H
+#define SIM_STATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "bitboard.h"
+#include "fixed_point.h"
+#include "flow_field.h"
+#include "snake.h"
+
+// A cut-down copy of the board for looking a few moves ahead: occupancy as a
+// Bitboard, the food, a random number generator and up to kMaxSnakes snakes
+// that move one whole cell per step. A rollout runs for at most kMaxSteps
+// steps, so of each body only the kMaxSteps cells nearest the tail can be
+// freed during one; those are all a snake keeps, in a fixed-size record that
+// is trivially copyable. Copying a state into another of the same board size
+// is a copy of the board's words and a few kilobytes of snakes, with no
+// allocation, so a planner can keep a root state plus a working copy and
+// clone one into the other for every rollout.
+//
+// Up to kMaxObstacles moving obstacles travel in straight lines as in the
+// game, each step before the snakes. Every snake moves at the same speed.
+class SimState {
+ public:
+  static constexpr int kMaxSnakes = 8;
+  static constexpr int kMaxSteps = 32;
+  static constexpr int kMaxObstacles = 16;
+
+  struct SimSnake {
+    int head;  // Cell index
+    bool alive;
+    int growth;  // Steps left before the tail moves again
+    int steps;   // Steps survived in this rollout
+    int eaten;   // Food eaten in this rollout
+    // Cells that will be freed as the tail moves, tail first, as a ring.
+    // The head's old cells are appended as it moves.
+    int trail[2 * kMaxSteps];
+    int trail_start;
+    int trail_count;
+  };
+  static_assert(std::is_trivially_copyable<SimSnake>::value,
+                "snakes are cloned by copying bytes");
+
+  struct SimObstacle {
+    Fixed x;
+    Fixed y;
+    Fixed dx;  // Per step
+    Fixed dy;
+    int cell;
+    bool covering;  // Entered a cell that was already blocked
+  };
+  static_assert(std::is_trivially_copyable<SimObstacle>::value,
+                "obstacles are cloned by copying bytes");
+
+  SimState(std::size_t grid_width, std::size_t grid_height);
+
+  // Starts a new root state from the game's occupancy and food (-1 for
+  // none), with no snakes. `seed` picks the random number sequence.
+  void Reset(const Bitboard &occupied, int food, std::uint64_t seed);
+  // Adds `snake`, taking the part of its body a rollout can free. False if
+  // there is no room for another snake.
+  bool AddSnake(Snake const &snake);
+  // Adds a moving obstacle at (x, y) moving (dx, dy) per step. False if
+  // there is no room for another.
+  bool AddObstacle(Fixed x, Fixed y, Fixed dx, Fixed dy);
+  int SnakeCount() const { return snake_count; }
+  void Reseed(std::uint64_t seed);
+
+  // Plays up to `steps` steps (at most kMaxSteps), snake 0 moving `first` on
+  // the first step and after the other snakes on every step. Every other
+  // move heads down `field` towards the food, while it is uneaten, three
+  // times in four, and to a random free neighbour otherwise. Stops early if
+  // snake 0 dies. Returns snake 0's steps survived plus `food_value` for
+  // each food it ate.
+  int Rollout(Snake::Direction first, int steps, const FlowField &field,
+              int food_value);
+
+ private:
+  // Rollout() on `grid`'s geometry.
+  template <typename Grid>
+  int Play(Grid grid, Snake::Direction first, int steps,
+           const FlowField &field, int food_value);
+  template <typename Grid>
+  static int Neighbour(Grid grid, int cell, Snake::Direction dir);
+  template <typename Grid>
+  bool Blocked(Grid grid, int cell) const {
+    return board.Test(grid.X(cell), grid.Y(cell));
+  }
+  template <typename Grid>
+  void StepObstacle(Grid grid, SimObstacle &obstacle);
+  std::uint32_t NextRandom();
+  // One step of `snake` onto `target`.
+  template <typename Grid>
+  void Move(Grid grid, SimSnake &snake, int target);
+
+  int width;
+  int height;
+  Bitboard board;
+  int food{-1};
+  std::uint64_t rng{1};
+  int snake_count{0};
+  int obstacle_count{0};
+  SimSnake snakes[kMaxSnakes];
+  SimObstacle obstacles[kMaxObstacles];
+};
+
+#endif
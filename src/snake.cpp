@@ -1,21 +1,19 @@
 #include "snake.h"
-#include <cmath>
+#include <algorithm>
 #include <iostream>
 
-void Snake::Update() {
-  SDL_Point prev_cell{
-      static_cast<int>(head_x),
-      static_cast<int>(
-          head_y)};  // We first capture the head's cell before updating.
+void Snake::Update(OccupancyGrid &occupancy) {
+  prev_head_x = head_x;
+  prev_head_y = head_y;
+  // We first capture the head's cell before updating, then after.
+  SDL_Point prev_cell = HeadCell();
   UpdateHead();
-  SDL_Point current_cell{
-      static_cast<int>(head_x),
-      static_cast<int>(head_y)};  // Capture the head's cell after updating.
+  SDL_Point current_cell = HeadCell();
 
   // Update all of the body vector items if the snake head has moved to a new
   // cell.
   if (current_cell.x != prev_cell.x || current_cell.y != prev_cell.y) {
-    UpdateBody(current_cell, prev_cell);
+    UpdateBody(current_cell, prev_cell, occupancy);
   }
 }
 
@@ -39,41 +37,63 @@ void Snake::UpdateHead() {
   }
 
   // Wrap the Snake around to the beginning if going off of the screen.
-  head_x = fmod(head_x + grid_width, grid_width);
-  head_y = fmod(head_y + grid_height, grid_height);
+  // SpeedUp() keeps a snake from moving a whole board in one tick, so one
+  // compare and add or subtract brings it back.
+  const Fixed width = FixedFromInt(grid_width);
+  const Fixed height = FixedFromInt(grid_height);
+  if (head_x < 0) head_x += width;
+  if (head_x >= width) head_x -= width;
+  if (head_y < 0) head_y += height;
+  if (head_y >= height) head_y -= height;
 }
 
-void Snake::UpdateBody(SDL_Point &current_head_cell, SDL_Point &prev_head_cell) {
-  // Add previous head location to vector
+void Snake::UpdateBody(SDL_Point &current_head_cell, SDL_Point &prev_head_cell,
+                       OccupancyGrid &occupancy) {
+  // Add previous head location to vector. Its cell is already marked as
+  // occupied from when the head entered it.
   body.push_back(prev_head_cell);
 
   if (!growing) {
-    // Remove the tail from the vector.
-    body.erase(body.begin());
+    // Remove the tail from the vector and release its cell.
+    occupancy.Clear(body.front().x, body.front().y, occupancy_tag);
+    body.pop_front();
   } else {
     growing = false;
     size++;
   }
 
-  // Check if the snake has died.
-  for (auto const &item : body) {
-    if (current_head_cell.x == item.x && current_head_cell.y == item.y) {
-      alive = false;
-    }
+  // Check if the snake has died: the new head cell is still covered by the
+  // body once the tail has moved on.
+  if (occupancy.Test(current_head_cell.x, current_head_cell.y, occupancy_tag)) {
+    alive = false;
   }
+  occupancy.Set(current_head_cell.x, current_head_cell.y, occupancy_tag);
 }
 
 void Snake::GrowBody() { growing = true; }
 
-// Inefficient method to check if cell is occupied by snake.
-bool Snake::SnakeCell(int x, int y) const {  // Modified: Added const
-  if (x == static_cast<int>(head_x) && y == static_cast<int>(head_y)) {
-    return true;
-  }
+void Snake::SpeedUp(Fixed amount) {
+  const Fixed limit = FixedFromInt(std::min(grid_width, grid_height)) - 1;
+  speed = std::min(speed + amount, limit);
+}
+
+void Snake::Restore(Snake const &other) {
+  direction = other.direction;
+  speed = other.speed;
+  size = other.size;
+  alive = other.alive;
+  head_x = other.head_x;
+  head_y = other.head_y;
+  prev_head_x = other.prev_head_x;
+  prev_head_y = other.prev_head_y;
+  body.Assign(other.body);
+  growing = other.growing;
+}
+
+void Snake::Occupy(OccupancyGrid &occupancy) const {
+  const SDL_Point head = HeadCell();
+  occupancy.Set(head.x, head.y, occupancy_tag);
   for (auto const &item : body) {
-    if (x == item.x && y == item.y) {
-      return true;
-    }
+    occupancy.Set(item.x, item.y, occupancy_tag);
   }
-  return false;
-}
\ No newline at end of file
+}
@@ -1,38 +1,82 @@
 #ifndef SNAKE_H
 #define SNAKE_H
 
-#include <vector>
+#include <cstdint>
 #include "SDL.h"
+#include "fixed_point.h"
+#include "occupancy_grid.h"
+#include "ring_buffer.h"
 
 class Snake {
  public:
   enum class Direction { kUp, kDown, kLeft, kRight };  // Already public
 
-  Snake(int grid_width, int grid_height)
-      : grid_width(grid_width),
-        grid_height(grid_height),
-        head_x(grid_width / 2),
-        head_y(grid_height / 2) {}
+  Snake(int grid_width, int grid_height, std::uint8_t occupancy_tag)
+      : head_x(FixedFromInt(grid_width / 2)),
+        head_y(FixedFromInt(grid_height / 2)),
+        prev_head_x(head_x),
+        prev_head_y(head_y),
+        body(static_cast<std::size_t>(grid_width) * grid_height),
+        occupancy_tag(occupancy_tag),
+        grid_width(grid_width),
+        grid_height(grid_height) {}
 
-  void Update();
+  // Advances the snake and keeps its cells in `occupancy` up to date.
+  void Update(OccupancyGrid &occupancy);
 
   void GrowBody();
-  bool SnakeCell(int x, int y) const;  // Modified: Added const
+  // Adds `amount` to the speed, which stays under a board's width and
+  // height so that UpdateHead() can wrap with one compare.
+  void SpeedUp(Fixed amount);
+  // Marks the snake's current head and body cells in `occupancy`.
+  void Occupy(OccupancyGrid &occupancy) const;
+
+  // A copy with room in its body for only the cells it has now, for keeping
+  // many past states cheaply. It must not be updated; copy it back into a
+  // full-sized snake with Restore() instead.
+  Snake Compact() const { return Snake(*this, body.size()); }
+  // Makes this snake a copy of `other`, a snake of the same board, keeping
+  // this one's body capacity.
+  void Restore(Snake const &other);
+
+  // The cell the head is in.
+  SDL_Point HeadCell() const { return {FixedCell(head_x), FixedCell(head_y)}; }
 
   Direction direction = Direction::kUp;
 
-  float speed{0.1f};
+  Fixed speed{FixedFromDouble(0.1)};  // Cells per tick
   int size{1};
   bool alive{true};
-  float head_x;
-  float head_y;
-  std::vector<SDL_Point> body;
+  Fixed head_x;
+  Fixed head_y;
+  Fixed prev_head_x;  // Head position before the last Update()
+  Fixed prev_head_y;
+  // Tail first, most recent cell last. Sized to the grid area so the body
+  // never reallocates however long the snake grows.
+  RingBuffer<SDL_Point> body;
 
  private:
+  Snake(Snake const &other, std::size_t capacity)
+      : direction(other.direction),
+        speed(other.speed),
+        size(other.size),
+        alive(other.alive),
+        head_x(other.head_x),
+        head_y(other.head_y),
+        prev_head_x(other.prev_head_x),
+        prev_head_y(other.prev_head_y),
+        body(other.body, capacity),
+        growing(other.growing),
+        occupancy_tag(other.occupancy_tag),
+        grid_width(other.grid_width),
+        grid_height(other.grid_height) {}
+
   void UpdateHead();
-  void UpdateBody(SDL_Point &current_cell, SDL_Point &prev_cell);
+  void UpdateBody(SDL_Point &current_cell, SDL_Point &prev_cell,
+                  OccupancyGrid &occupancy);
 
   bool growing{false};
+  std::uint8_t occupancy_tag;
   int grid_width;
   int grid_height;
 };
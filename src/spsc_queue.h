@@ -0,0 +1,46 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Each index is written by one side only, so a release store paired
+// with an acquire load is all the synchronisation needed.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+ public:
+  // Producer side. Returns false, dropping `item`, when the queue is full.
+  bool Push(const T &item) {
+    const std::size_t tail = write_index.load(std::memory_order_relaxed);
+    if (tail - read_index.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    items[tail & (Capacity - 1)] = item;
+    write_index.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false when the queue is empty.
+  bool Pop(T &item) {
+    const std::size_t head = read_index.load(std::memory_order_relaxed);
+    if (head == write_index.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = items[head & (Capacity - 1)];
+    read_index.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  std::array<T, Capacity> items{};
+  // On separate cache lines so the two threads don't false-share.
+  alignas(64) std::atomic<std::size_t> write_index{0};
+  alignas(64) std::atomic<std::size_t> read_index{0};
+};
+
+#endif
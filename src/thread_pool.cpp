@@ -0,0 +1,106 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace {
+// The pool this thread works for (null off any pool) and its worker index
+// there, which is only meaningful while current_pool is set. Lets tasks that
+// submit more tasks keep them on their own deque.
+thread_local const ThreadPool *current_pool = nullptr;
+thread_local std::size_t current_worker = 0;
+}  // namespace
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (std::size_t i = 0; i < threads; ++i) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+  for (std::size_t i = 0; i < threads; ++i) {
+    workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex);
+    stopping = true;
+  }
+  work_available.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  std::size_t index = current_pool == this
+                          ? current_worker
+                          : next_queue.fetch_add(1) % queues.size();
+  unfinished.fetch_add(1);
+  {
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    queues[index]->tasks.push_back(std::move(task));
+  }
+  // Taking the idle lock orders this push before any worker's re-check, so a
+  // worker about to sleep can't miss the wakeup.
+  { std::lock_guard<std::mutex> lock(idle_mutex); }
+  work_available.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(idle_mutex);
+  all_done.wait(lock, [this] { return unfinished.load() == 0; });
+}
+
+bool ThreadPool::PopLocal(std::size_t index, std::function<void()> &task) {
+  Queue &queue = *queues[index];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) return false;
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  return true;
+}
+
+bool ThreadPool::Steal(std::size_t thief, std::function<void()> &task) {
+  for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+    Queue &queue = *queues[(thief + offset) % queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) continue;
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop(std::size_t index) {
+  current_pool = this;
+  current_worker = index;
+
+  std::function<void()> task;
+  while (true) {
+    if (PopLocal(index, task) || Steal(index, task)) {
+      task();
+      task = nullptr;
+      if (unfinished.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+        all_done.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(idle_mutex);
+    if (stopping) return;
+    // Re-check under the lock: Submit() takes it after pushing, so either
+    // the task is visible now or the notify comes after we start waiting.
+    bool pending = false;
+    for (auto &queue : queues) {
+      std::lock_guard<std::mutex> queue_lock(queue->mutex);
+      if (!queue->tasks.empty()) {
+        pending = true;
+        break;
+      }
+    }
+    if (!pending) work_available.wait(lock);
+  }
+}
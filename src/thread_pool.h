@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads with work stealing. Every worker owns a
+// deque: it pushes and pops its own tasks at the back (newest first, which
+// keeps caches warm) and, once that runs dry, steals from the front of the
+// other workers' deques (oldest first, which tends to grab the biggest
+// remaining chunks). Tasks submitted from outside the pool are dealt out
+// round-robin.
+class ThreadPool {
+ public:
+  // Zero means one worker per hardware thread.
+  explicit ThreadPool(std::size_t threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void Submit(std::function<void()> task);
+  // Blocks until every submitted task has finished.
+  void Wait();
+
+  std::size_t Size() const { return queues.size(); }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void WorkerLoop(std::size_t index);
+  bool PopLocal(std::size_t index, std::function<void()> &task);
+  bool Steal(std::size_t thief, std::function<void()> &task);
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+
+  // Tasks submitted but not yet finished, and the lock/condition pairs used
+  // to park idle workers and waiters.
+  std::atomic<std::size_t> unfinished{0};
+  std::atomic<std::size_t> next_queue{0};
+  std::mutex idle_mutex;
+  std::condition_variable work_available;
+  std::condition_variable all_done;
+  bool stopping{false};
+};
+
+#endif
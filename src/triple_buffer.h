@@ -0,0 +1,47 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Lock-free single-writer, single-reader handoff of the latest value. The
+// writer fills its back slot and publishes it by swapping it with the middle
+// slot; the reader swaps the middle slot into its front slot when something
+// new is there. Neither side ever waits for the other, and the reader always
+// gets the most recent complete value (older unread ones are dropped).
+template <typename T>
+class TripleBuffer {
+ public:
+  // Every slot is built from the same arguments, e.g. to reserve capacity.
+  template <typename... Args>
+  explicit TripleBuffer(const Args &...args)
+      : slots{T(args...), T(args...), T(args...)} {}
+
+  TripleBuffer(const TripleBuffer &) = delete;
+  TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+  // Writer side.
+  T &WriteSlot() { return slots[back]; }
+  void Publish() {
+    back = middle.exchange(back | kFresh, std::memory_order_acq_rel) & kIndex;
+  }
+
+  // Reader side. Returns true if a newer value was published since the last
+  // call, in which case ReadSlot() now refers to it.
+  bool Acquire() {
+    if ((middle.load(std::memory_order_relaxed) & kFresh) == 0) return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & kIndex;
+    return true;
+  }
+  const T &ReadSlot() const { return slots[front]; }
+
+ private:
+  static constexpr int kIndex = 0x3;
+  static constexpr int kFresh = 0x4;  // Set while the middle slot is unread
+
+  T slots[3];
+  int back{0};   // Owned by the writer
+  int front{1};  // Owned by the reader
+  std::atomic<int> middle{2};
+};
+
+#endif